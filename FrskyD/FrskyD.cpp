@@ -27,6 +27,16 @@
  * 2 | 1s    | GPS (except date and time), fuel level
  * 3 | 5s    | GPS date and time
  * 
+ * A sensor can behave the same way: the values are set in FrskyDFrame objects, attached with FrskyD::attach(), and
+ * FrskyD::update() sends each frame in one burst when its period is over - loop() never has to wait.
+ * 
+ * At 9600bds, a byte takes about 1ms. FrskyD::async() moves the sending to the background (see FrskyDTxQueue): the
+ * packets are only queued, and the line is driven by update() one byte at a time, or by the Timer2 interrupt when the
+ * sketch includes FrskyDTimer2.h.
+ * 
+ * SoftwareSerial is only the default: a hardware UART, AltSoftSerial or a Linux tty can be used instead, each one
+ * reporting its turnaround (see FrskyDTransport).
+ * 
  * Some sensors behavior
  * ---------------------
  * Some sensors, such as VFAS, FLVS-01 or FVAS-02 can send D protocol telemetry without the hub.
@@ -47,6 +57,14 @@
  * * 0x5E (header / footer)  -> 0x5D 0x3E
  * * 0x5D (exception marker) -> 0x5D 0x3D
  * 
+ * Some values are sent as 2 packets: B (before ".") and A (after "."). Use FrskyDPairs to get them as consistent
+ * pairs.
+ * 
+ * The scale, unit and B/A pairing of each ID are in FrskyDSensors::table (see FrskyDCodec and FrskyDSensors::lookup()).
+ *
+ * FrskyDPins<RX, TX> replaces FrskyD (RX, TX) without heap allocation for the transport. tools/host/footprint
+ * ("make size") reports the RAM and code size of each feature.
+ * 
  * Connection draft
  * ----------------
  *  \image html D_ports_bb.png
@@ -74,22 +92,137 @@
 #define DEBUG
 
 /**
- * Open a SoftwareSerial connection
+ * Open a SoftwareSerial connection (see FrskyDSoftSerial)
  * \param pinRx RX pin
  * \param pinTx TX pin
  * \brief Class constructor
  */
 FrskyD::FrskyD (int pinRx, int pinTx) {
-    this->mySerial = new SoftwareSerial (pinRx, pinTx, true);
-    this->mySerial->begin (9600);
+    FrskyDSoftSerial *soft = new FrskyDSoftSerial (pinRx, pinTx);
+
+    this->transport = soft;
+    this->mySerial  = &soft->serial;
+    this->transport->begin (FRSKY_D_SPEED);
+    this->_pinTx = pinTx;
+}
+
+/**
+ * Use a hardware UART, AltSoftSerial or a Linux tty instead of SoftwareSerial (see FrskyDTransport). The transport is
+ * not opened here - a global FrskyD may be constructed before the serial port: call its begin() from setup().
+ * \brief Class constructor, on a transport
+ * \param transport transport
+ */
+FrskyD::FrskyD (FrskyDTransport &transport) {
+    this->transport = &transport;
+    this->mySerial  = NULL;
+    this->_pinTx = -1;
+}
+
+/**
+ * From now on, sendData(), sendFloat(), sendCellVolt() and send() only queue the packets, and never wait for the line
+ * (see FrskyDTxQueue). Call it from setup().
+ *
+ * The queue is drained by update() (or step()), one byte per call. On AVR, include FrskyDTimer2.h in the sketch to
+ * drain it with the Timer2 interrupt instead (SoftwareSerial transport only).
+ * \brief Send in the background
+ */
+void FrskyD::async () {
+    if (this->txQueue == NULL) this->txQueue = new FrskyDTxQueue (this->_pinTx, FRSKY_D_SPEED);
+}
+
+/**
+ * The frame is sent by update() each time its period is over. A frame can only be attached once.
+ * \brief Attach a frame
+ * \param frame frame (see FrskyDFrame)
+ */
+void FrskyD::attach (FrskyDFrameBase *frame) {
+    FrskyDFrameBase **p;
+
+    for (p = &this->_frames; *p; p = &(*p)->_next) {
+        if (*p == frame) return;            // already attached
+    }
+    frame->_next = NULL;
+    *p = frame;
 }
 
 /**
  * Check if a byte is available
- * \brief SoftwareSerial.available() passtrhough
+ * \brief FrskyDTransport::available() passtrhough
  */
 bool FrskyD::available () {
-    return this->mySerial->available ();
+    return this->transport->available ();
+}
+
+/**
+ * Byte-fed decoder: give it every byte received from the hub or the sensors. The exceptions (0x5D 0x3E and
+ * 0x5D 0x3D) are decoded on the fly, and each complete packet is given to the handler registered with onValue().
+ * Nothing is buffered but the current packet (ID and first data byte): a broken packet is dropped at the next
+ * header (see stats()).
+ * 
+ * \brief Feed the decoder with one received byte
+ * \param b received byte
+ * \return true if b completes a packet
+ */
+bool FrskyD::feed (byte b) {
+    if (b == FRSKY_D_HEADER) {              // header or footer - always starts a new packet
+        if (this->_rxState > 1) FrskyDStats::count (this->_stats.dropped);
+        this->_rxState  = 1;
+        this->_rxEscape = false;
+        return false;
+    }
+
+    switch (this->_rxState) {
+        case 0:                             // wait for a header
+            return false;
+
+        case 1:                             // sensor ID
+            this->_rxId    = b;
+            this->_rxState = 2;
+            return false;
+    }
+
+    if (b == FRSKY_D_ESCAPE && !this->_rxEscape) {
+        this->_rxEscape = true;
+        return false;
+    }
+    if (this->_rxEscape) {
+        this->_rxEscape = false;
+        if (b != 0x3E && b != 0x3D) {       // not an exception - drop the packet
+            this->_rxState = 0;
+            FrskyDStats::count (this->_stats.dropped);
+            return false;
+        }
+        b ^= 0x60;                          // 0x3E -> 0x5E, 0x3D -> 0x5D
+        FrskyDStats::count (this->_stats.unstuffed);
+    }
+
+    if (this->_rxState == 2) {
+        this->_rxLow   = b;
+        this->_rxState = 3;
+        return false;
+    }
+
+    this->_rxState = 0;                     // wait for the footer
+    FrskyDStats::count (this->_stats.packets);
+    if (this->_handler) this->_handler (this->_rxId, (int16_t) (b << 8 | this->_rxLow));
+    return true;
+}
+
+/**
+ * The handler is called by feed() (and so by update()) for each decoded packet.
+ * ~~~~~
+ * void printValue (uint8_t id, int16_t val) {
+ *   if (id == FRSKY_D_RPM) Serial.println (val);
+ * }
+ * 
+ * FrskyD.onValue (printValue);
+ * ~~~~~
+ * 
+ * \brief Register the value handler
+ * \param handler handler (NULL to remove it)
+ */
+void FrskyD::onValue (FrskyDHandler handler) {
+    this->_handler = handler;
 }
 
 /**
@@ -103,6 +236,18 @@ float FrskyD::calcFloat (int16_t bp, uint16_t ap) {
     else        return (float) bp - (float) ap / 100.0;
 }
 
+/**
+ * Same as calcFloat(), without any float.
+ * \brief Value of a B/A pair, in hundredths
+ * \param bp value before "."
+ * \param ap value after "."
+ * \return value * 100
+ */
+int32_t FrskyD::calcFixed (int16_t bp, uint16_t ap) {
+    if (bp > 0) return (int32_t) bp * 100 + ap;
+    else        return (int32_t) bp * 100 - ap;
+}
+
 /**
  * Return 2 bytes as signed integer
  * 
@@ -153,22 +298,78 @@ int FrskyD::decodeCellVoltId (byte *buffer) {
     return (buffer[0] & 0xF0) >> 4;
 }
 
+/*
+ * Write the decimal digits of val (at least width, zero padded) at p, and return the next position
+ */
+static char *_digits (char *p, uint16_t val, uint8_t width) {
+    char    digits[5];
+    uint8_t n = 0;
+
+    do { digits[n++] = '0' + val % 10; val /= 10; } while (val || n < width);
+    while (n) *p++ = digits[--n];
+    return p;
+}
+
+/**
+ * The values are taken from the bus as they come: out of range fields are clamped (see FrskyDGps), and a coordinate
+ * beyond 180 degrees reads 180d 0m 0s.
+ * \brief Decode a GPS coordinate, without any float or heap allocation
+ * \param bp value B (ddmm, \ref FRSKY_D_GPS_LAT_B or \ref FRSKY_D_GPS_LONG_B)
+ * \param ap value A (mmmm, \ref FRSKY_D_GPS_LAT_A or \ref FRSKY_D_GPS_LONG_A)
+ * \param hemisphere value of \ref FRSKY_D_GPS_LAT_NS or \ref FRSKY_D_GPS_LONG_EW ('N', 'S', 'E', 'W'), 0 if unknown
+ * \return coordinate
+ */
+FrskyDGps FrskyD::decodeGps (int16_t bp, uint16_t ap, char hemisphere) {
+    FrskyDGps gps;
+    uint16_t  ddmm = bp < 0 ? -bp : bp;
+
+    if (ddmm > 18000 || (ddmm == 18000 && ap)) {
+        gps.deg  = 180;
+        gps.min  = 0;
+        gps.frac = 0;
+    } else {
+        gps.deg  = ddmm / 100;
+        gps.min  = ddmm % 100 > 59 ? 59 : ddmm % 100;
+        gps.frac = ap > 9999 ? 9999 : ap;
+    }
+    gps.hemisphere = hemisphere;
+    return gps;
+}
+
+/**
+ * Writes ex. "46d 42m 52.5180s N" - the seconds are computed as integers (1/10000 minute = 0.006 s), and nothing is
+ * allocated. The fields are written as they are: a FrskyDGps filled by hand, out of its ranges, still fits in
+ * \ref FRSKY_D_GPS_FORMAT_SIZE bytes.
+ * \brief Format a GPS coordinate as degrees, minutes and seconds
+ * \param gps coordinate (see decodeGps())
+ * \param buffer destination (\ref FRSKY_D_GPS_FORMAT_SIZE bytes)
+ * \return length of the string written (without the final null)
+ */
+uint8_t FrskyD::formatGps (const FrskyDGps &gps, char *buffer) {
+    uint32_t s = (uint32_t) gps.frac * 60;  // 1/10000 seconds
+    char    *p = buffer;
+
+    p = _digits (p, gps.deg, 1);            *p++ = 'd'; *p++ = ' ';
+    p = _digits (p, gps.min, 1);            *p++ = 'm'; *p++ = ' ';
+    p = _digits (p, s / 10000, 1);          *p++ = '.';
+    p = _digits (p, s % 10000, 4);          *p++ = 's';
+    if (gps.hemisphere) { *p++ = ' '; *p++ = gps.hemisphere; }
+    *p = 0;
+    return p - buffer;
+}
+
 /**
  * \brief Decode the \ref FRSKY_D_GPS_LAT_B packets
  * \param bp value B (before ".")
  * \param ap value A (after ".")
  * \return latitude
+ * \deprecated allocates a String - use decodeGps() and formatGps()
  */
 String FrskyD::decodeGpsLat (int16_t bp, uint16_t ap) {
-    int   d    = bp / 100;            // two frist numbers of bp
-    int   m    = bp % 100;            // two last numbers of bp
-    float s    = ap * 0.006;          // * 60 / 1000
-    int   sint = (int) s;             // decimal part of s
-    int   sdec = (s - sint) * 10000;  // floating part of s
-  
-    String gpsLatRaw = String (String(bp) + "." + String(ap));
-    String gpsLatStr = String (String(d) + "d " + String(m) + "m " + String(sint) + "." + String (sdec) + "s");
-    return String (gpsLatStr+ " (raw: " + gpsLatRaw + ")");
+    char buffer[FRSKY_D_GPS_FORMAT_SIZE];
+
+    FrskyD::formatGps (FrskyD::decodeGps (bp, ap), buffer);
+    return String (buffer) + " (raw: " + bp + "." + ap + ")";
 }
 
 /**
@@ -176,17 +377,42 @@ String FrskyD::decodeGpsLat (int16_t bp, uint16_t ap) {
  * \param bp value B (before ".")
  * \param ap value A (after ".")
  * \return longitude
+ * \deprecated allocates a String - use decodeGps() and formatGps()
  */
 String FrskyD::decodeGpsLong (int16_t bp, uint16_t ap) {
-    int   d    = bp / 100;            // two frist numbers of bp
-    int   m    = bp % 100;            // two last numbers of bp
-    float s    = ap * 0.006;          // * 60 / 1000
-    int   sint = (int) s;             // decimal part of s
-    int   sdec = (s - sint) * 10000;  // floating part of s
-  
-    String gpsLongRaw = String (String(bp) + "." + String(ap));
-    String gpsLongStr = String (String(d) + "d " + String(m) + "m " + String(sint) + "." + String (sdec) + "s");
-    return String (gpsLongStr + " (raw: " + gpsLongRaw + ")");
+    char buffer[FRSKY_D_GPS_FORMAT_SIZE];
+
+    FrskyD::formatGps (FrskyD::decodeGps (bp, ap), buffer);
+    return String (buffer) + " (raw: " + bp + "." + ap + ")";
+}
+
+/**
+ * Encode a packet without its footer: header, sensor ID, and data with the exceptions (0x5E and 0x5D) re-encoded.
+ * The next header is the footer.
+ * \brief Encode a packet in a buffer
+ * \param buffer destination (6 bytes at most)
+ * \param id sensor ID
+ * \param val preformated value
+ * \return number of bytes encoded (4~6)
+ */
+uint8_t FrskyD::encode (uint8_t *buffer, uint8_t id, int16_t val) {
+    uint8_t d[2];
+    uint8_t i, n = 0;
+
+    d[0] =  val & 0x00ff;
+    d[1] = (val & 0xff00) >> 8;
+
+    buffer[n++] = FRSKY_D_HEADER;
+    buffer[n++] = id;
+
+    for (i=0; i<2; i++) {
+        if (d[i] == FRSKY_D_HEADER || d[i] == FRSKY_D_ESCAPE) {
+            buffer[n++] = FRSKY_D_ESCAPE;
+            buffer[n++] = d[i] ^ 0x60;      // 0x5E -> 0x3E, 0x5D -> 0x3D
+        }
+        else buffer[n++] = d[i];
+    }
+    return n;
 }
 
 /**
@@ -199,23 +425,89 @@ uint16_t FrskyD::_fixForbiddenValues (uint16_t val) {
 }
 
 /**
- * \brief SoftwareSerial.read() passthrough
+ * \brief FrskyDTransport::read() passthrough
  */
 byte FrskyD::read () {
-    return this->mySerial->read ();
+    return this->transport->read ();
 }
 
 /**
- * \brief Send lipo cell voltage (specific to \ref FRSKY_D_CELL_VOLT)
+ * The packets are encoded in a buffer of \ref FRSKY_D_BURST bytes, that is written as soon as it is full: the frame
+ * goes out as one burst, with no gap between the packets, and a single footer at the end.
+ *
+ * When sending in the background (see async()), only the packets that fit in the queue are queued. Call send() again
+ * with the same frame to queue the rest (update() does it). When not even one packet fits, nothing is written, and
+ * the frame counts as refused (FrskyDStats::overflows).
+ * \brief Send all the values of a frame
+ * \param frame frame (see FrskyDFrame)
+ * \return true if the whole frame is sent (or queued)
+ */
+bool FrskyD::send (FrskyDFrameBase &frame) {
+    uint8_t  buffer[FRSKY_D_BURST];
+    uint16_t room = this->txQueue ? this->txQueue->space () : 0xffff;
+    uint16_t used = 0;
+    uint8_t  n = 0, len;
+
+    frame._txBusy = true;
+    while (frame._txNext < frame._count) {
+        if (n > FRSKY_D_BURST - 6) {
+            this->_write (buffer, n);
+            used += n;
+            n = 0;
+        }
+        len = FrskyD::encode (&buffer[n], frame._values[frame._txNext].id, frame._values[frame._txNext].val);
+        if (used + n + len > room) break;   // queue full
+        n += len;
+        frame._txNext++;
+    }
+    if (frame._txNext == frame._count && used + n < room) {
+        buffer[n++] = FRSKY_D_HEADER;       // footer
+        frame._txNext = 0;
+        frame._txBusy = false;
+    }
+    if (n) {
+        this->_write (buffer, n);
+    } else if (!used) {
+        FrskyDStats::count (this->_stats.overflows);    // not even a packet fits: refused, as by _write()
+    }
+    return !frame._txBusy;
+}
+
+/**
+ * The value holds the cell ID in its 4 high bits of the first byte, and the voltage / 2 mV on 12 bits (V * 500). Used
+ * by sendCellMv(), sendCellVolt() and FrskyDFrameBase::setCellMv(), FrskyDFrameBase::setCellVolt().
+ * \brief Preformated value of a lipo cell voltage (\ref FRSKY_D_CELL_VOLT)
  * \param id cell ID
- * \param val voltage
+ * \param mv voltage [mV]
+ * \return value to send with the ID \ref FRSKY_D_CELL_VOLT
  */
-void FrskyD::sendCellVolt (uint8_t id, float val) {
-    uint16_t voltage = val * 500;
+uint16_t FrskyD::cellValue (uint8_t id, uint16_t mv) {
+    uint16_t voltage = mv >> 1;
     uint8_t v1 = (voltage & 0x0f00) >> 8 | (id << 4 & 0xf0);
     uint8_t v2 = (voltage & 0x00ff);
-    uint16_t value = (v1 & 0x00ff) | (v2 << 8);
-    this->sendData (FRSKY_D_CELL_VOLT, value);
+
+    return (v1 & 0x00ff) | (v2 << 8);
+}
+
+/**
+ * Same as sendCellVolt(), without any float: V * 500 is mV / 2.
+ * \brief Send lipo cell voltage from millivolts (specific to \ref FRSKY_D_CELL_VOLT)
+ * \param id cell ID
+ * \param mv voltage [mV]
+ * \return false if the packet could not be queued (see async())
+ */
+bool FrskyD::sendCellMv (uint8_t id, uint16_t mv) {
+    return this->sendData (FRSKY_D_CELL_VOLT, FrskyD::cellValue (id, mv));
+}
+
+/**
+ * \brief Send lipo cell voltage (specific to \ref FRSKY_D_CELL_VOLT)
+ * \param id cell ID
+ * \param val voltage
+ * \return false if the packet could not be queued (see async())
+ */
+bool FrskyD::sendCellVolt (uint8_t id, float val) {
+    return this->sendData (FRSKY_D_CELL_VOLT, FrskyD::cellValue (id, val * 1000));
 }
 
 /**
@@ -231,24 +523,37 @@ void FrskyD::sendCellVolt (uint8_t id, float val) {
  * \see http://www.rcgroups.com/forums/showthread.php?t=1874973
  * \param id sensor ID
  * \param val preformated value
+ * \return false if the packet could not be queued (see async())
  */
-void FrskyD::sendData (uint8_t id, int16_t val) {
-    int8_t d[2];
-    int i;
-    
-    d[0] =  val & 0x00ff;
-    d[1] = (val & 0xff00) >> 8;
+bool FrskyD::sendData (uint8_t id, int16_t val) {
+    uint8_t buffer[7];
+    uint8_t n;
 
-    this->mySerial->write (0x5E);
-    this->mySerial->write (id);
+    n = FrskyD::encode (buffer, id, val);
+    buffer[n++] = FRSKY_D_HEADER;           // End of frame
+    return this->_write (buffer, n);
+}
 
-    for (i=0; i<2; i++) {
-        if      (d[i] == 0x5E) { this->mySerial->write (0x5D); this->mySerial->write (0x3E); }
-        else if (d[i] == 0x5D) { this->mySerial->write (0x5D); this->mySerial->write (0x3D); }
-        else                     this->mySerial->write (d[i]);
-    }
+/**
+ * Same packets as sendFloat(), without any float: the value is given in hundredths (ex. 12345 for 123.45). Both
+ * packets are queued, or none.
+ * \brief Send a fixed-point value as 2 packets (before "." and after ".")
+ * \param idb ID B (before ".")
+ * \param ida ID A (after ".")
+ * \param val value * 100 (-3276799 ~ 3276799)
+ * \return false if the packets could not be queued (see async())
+ */
+bool FrskyD::sendFixed (uint8_t idb, uint8_t ida, int32_t val) {
+    int16_t  bp = val / 100;
+    uint16_t ap = (val < 0 ? -val : val) % 100;
+    uint8_t  buffer[14];
+    uint8_t  n;
 
-    this->mySerial->write (0x5E);   // End of frame
+    n  = FrskyD::encode (buffer, idb, bp);
+    buffer[n++] = FRSKY_D_HEADER;
+    n += FrskyD::encode (&buffer[n], ida, ap);
+    buffer[n++] = FRSKY_D_HEADER;
+    return this->_write (buffer, n);
 }
 
 /**
@@ -256,18 +561,107 @@ void FrskyD::sendData (uint8_t id, int16_t val) {
  * \param idb ID B (before ".")
  * \param ida ID A (after ".")
  * \param val value
+ * \return false if the packets could not be queued (see async()) - both are queued, or none
  */
-void FrskyD::sendFloat (uint8_t idb, uint8_t ida, float val) {
+bool FrskyD::sendFloat (uint8_t idb, uint8_t ida, float val) {
     int16_t  bp = (int16_t) val;
     uint16_t ap;
+    uint8_t  buffer[14];
+    uint8_t  n;
+
     if (val >= 0) ap = (val - bp) * 100;
-    else          ap = (bp - val) * 100; 
-    Serial.print ("float: ");
-    Serial.print (val);
-    Serial.print (", bp: ");
-    Serial.print (bp);
-    Serial.print (", ap: ");
-    Serial.println (ap);
-    this->sendData (idb, bp);
-    this->sendData (ida, ap);
+    else          ap = (bp - val) * 100;
+
+    n  = FrskyD::encode (buffer, idb, bp);
+    buffer[n++] = FRSKY_D_HEADER;
+    n += FrskyD::encode (&buffer[n], ida, ap);
+    buffer[n++] = FRSKY_D_HEADER;
+    return this->_write (buffer, n);
+}
+
+/**
+ * Reads only what is already received, sends the attached frames whose period is over, and (unless the Timer2
+ * interrupt does it, see FrskyDTimer2.h) one byte of the transmit queue. Call it as often as possible from loop().
+ * \brief Decode the received bytes, and send the frames that are due
+ * \return number of packets decoded
+ */
+int FrskyD::update () {
+    int n = 0;
+    int b;
+
+    while (this->available ()) n += this->feed (this->read ());
+    if (this->transport->overflow ()) FrskyDStats::count (this->_stats.overflows);
+
+    if (this->txQueue && !this->txQueue->interrupt () && (b = this->txQueue->pop ()) >= 0) this->transport->write (b);
+    this->_sendFrames ();
+    return n;
+}
+
+/**
+ * One piece of work at a time, in this order: one received byte, one byte of the transmit queue (unless the Timer2
+ * interrupt sends it, see FrskyDTimer2.h), or the frames that are due. Several lines or buses can then be served in
+ * turn (see FrskySPPump in the FrskySP library). Use async(), or each frame is sent whole within the step.
+ * \brief Decode one received byte, or send
+ * \return true if something was done
+ */
+bool FrskyD::step () {
+    int b;
+
+    if (this->available ()) {
+        this->feed (this->read ());
+        return true;
+    }
+    if (this->transport->overflow ()) FrskyDStats::count (this->_stats.overflows);
+    if (this->txQueue && !this->txQueue->interrupt () && (b = this->txQueue->pop ()) >= 0) {
+        this->transport->write (b);
+        return true;
+    }
+    return this->_sendFrames ();
+}
+
+/**
+ * \brief Send the attached frames whose period is over
+ * \return true if a frame was sent (or queued)
+ */
+bool FrskyD::_sendFrames () {
+    FrskyDFrameBase *frame;
+    unsigned long    now = millis ();
+    bool sent = false;
+
+    for (frame = this->_frames; frame; frame = frame->_next) {
+        if (!frame->_txBusy) {
+            if (!frame->due (now)) continue;
+            frame->_sentAt = now;
+            frame->_sent   = true;
+        }
+        if (!this->send (*frame)) break;    // queue full - the next frames wait for the next call
+        sent = true;
+    }
+    return sent;
+}
+
+/**
+ * \brief Write bytes, or queue them when sending in the background (see async())
+ * \param buffer bytes
+ * \param len number of bytes
+ * \return false if the bytes could not be queued
+ */
+bool FrskyD::_write (const uint8_t *buffer, uint8_t len) {
+    uint8_t i;
+
+    if (!this->txQueue) {
+        for (i=0; i<len; i++) this->transport->write (buffer[i]);
+    } else if (!this->txQueue->push (buffer, len)) {
+        FrskyDStats::count (this->_stats.overflows);
+        return false;
+    }
+    FrskyDStats::count (this->_stats.sent);
+    return true;
+}
+
+/**
+ * \brief Clear the bus health counters (see FrskyDStats)
+ */
+void FrskyD::statsReset () {
+    this->_stats = FrskyDStats ();
 }
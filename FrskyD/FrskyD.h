@@ -2,8 +2,37 @@
  * \file FrskyD.h
  */
 
+#ifndef FrskyD_h
+#define FrskyD_h
+
 #include "Arduino.h"
 #include "SoftwareSerial.h"
+#include "FrskyDFrame.h"
+#include "FrskyDGps.h"
+#include "FrskyDPairs.h"
+#include "FrskyDStats.h"
+#include "FrskyDTransport.h"
+#include "FrskyDTxQueue.h"
+
+/**
+ * \brief Packet header and footer (0x5E), and the two bytes used to encode it in data (0x5D 0x3E)
+ */
+#define FRSKY_D_HEADER       0x5E
+
+/**
+ * \brief Exception marker (0x5D), and the two bytes used to encode it in data (0x5D 0x3D)
+ */
+#define FRSKY_D_ESCAPE       0x5D
+
+/**
+ * \brief Size of the buffer a frame is encoded in before being sent (see FrskyD::send())
+ */
+#define FRSKY_D_BURST        64
+
+/**
+ * \brief D protocol speed [bds]
+ */
+#define FRSKY_D_SPEED        9600
 
 /**
  * info   | comment
@@ -221,7 +250,7 @@
  * info   | comment
  * ----   | -------
  * ID(s)  | 0x22
- * value  | ?
+ * value  | (char) 'E' or 'W'
  *
  * \todo GPS only works for East at now
  */
@@ -231,7 +260,7 @@
  * info   | comment
  * ----   | -------
  * ID(s)  | 0x23
- * value  | ?
+ * value  | (char) 'N' or 'S'
  *
  * \todo GPS only works for North at now
  */
@@ -327,33 +356,104 @@
  */
 #define FRSKY_D_VOLTAGE_A    0x3B    // FAS40, FAS100
 
+#include "FrskyDSensors.h"           // table of the IDs above
+
+/**
+ * Value handler, called with the sensor ID and the value of each decoded packet
+ */
+typedef void (*FrskyDHandler) (uint8_t id, int16_t val);
+
 /**
  * Frsky D class
  */
 class FrskyD {
+  template <uint8_t, uint8_t> friend class FrskyDPins;
+
   public:
     // objetcs
     FrskyD (int pinRx, int pinTx);
-    SoftwareSerial *mySerial;         //!<SoftwareSerial object
+    FrskyD (FrskyDTransport &transport);
+    SoftwareSerial *mySerial;         //!<SoftwareSerial object (NULL with another transport)
+    FrskyDTransport *transport;       //!<transport (see FrskyDTransport)
+    FrskyDTxQueue  *txQueue = NULL;   //!<transmit queue (see async()), NULL if the sending is synchronous
 
     // methods
+    void   async ();
+    void   attach (FrskyDFrameBase *frame);
     bool   available ();
-
-    float   calcFloat (int16_t bp, uint16_t ap);
-    int16_t decodeInt   (byte *buffer);
+    bool   feed (byte b);
+    void   onValue (FrskyDHandler handler);
+    int    update ();
+
+    static float   calcFloat (int16_t bp, uint16_t ap);
+    static uint16_t cellValue (uint8_t id, uint16_t mv);
+    static int32_t calcFixed (int16_t bp, uint16_t ap);
+    static int16_t decodeInt (byte *buffer);
     uint8_t decode1Int  (byte *buffer);
         
     float  decodeCellVolt   (byte *buffer);
     int    decodeCellVoltId (byte *buffer);
     String decodeGpsLat     (int16_t bp, uint16_t ap);
     String decodeGpsLong    (int16_t bp, uint16_t ap);
+
+    static FrskyDGps decodeGps (int16_t bp, uint16_t ap, char hemisphere = 0);
+    static uint8_t   formatGps (const FrskyDGps &gps, char *buffer);
     
     uint16_t _fixForbiddenValues (uint16_t val);
     byte   read ();
     
-    void   sendCellVolt (uint8_t id, float val);
-    void   sendData  (uint8_t id, int16_t val);
-    void   sendFloat (uint8_t idb, uint8_t ida, float val);
+    bool   send (FrskyDFrameBase &frame);
+    bool   sendCellMv (uint8_t id, uint16_t mv);
+    bool   sendCellVolt (uint8_t id, float val);
+    bool   sendData  (uint8_t id, int16_t val);
+    bool   sendFixed (uint8_t idb, uint8_t ida, int32_t val);
+    bool   sendFloat (uint8_t idb, uint8_t ida, float val);
+    FrskyDStats stats () const { return this->_stats; }    //!<snapshot of the bus health counters
+    void   statsReset ();
+    bool   step ();
+
+    static uint8_t encode (uint8_t *buffer, uint8_t id, int16_t val);
+
+  private:
+    bool   _sendFrames ();
+    bool   _write (const uint8_t *buffer, uint8_t len);
+
+    int8_t  _pinTx;                   //!<TX pin (-1 with another transport)
+    FrskyDFrameBase *_frames = NULL;  //!<attached frames (see attach())
+    FrskyDHandler _handler = NULL;    //!<value handler (see onValue())
+    uint8_t _rxState = 0;             //!<decoder state (0: wait header, 1: ID, 2~3: data bytes)
+    bool    _rxEscape = false;        //!<last byte was an exception marker
+    uint8_t _rxId;                    //!<ID of the packet being decoded
+    uint8_t _rxLow;                   //!<first data byte of the packet being decoded
+    FrskyDStats _stats = {};          //!<see stats()
+};
+
+/**
+ * FrskyD on SoftwareSerial, with the pins given when compiling: the transport is a member, not allocated on the heap
+ * as FrskyD::FrskyD(int, int) does. A global object then takes a fixed amount of RAM, known at link time. async()
+ * still allocates its queue.
+ * ~~~~~
+ * FrskyDPins<10, 11> FrskyD;                                      // instead of: FrskyD FrskyD (10, 11);
+ * ~~~~~
+ * \brief FrskyD on SoftwareSerial, pins known when compiling
+ * \tparam RX RX pin
+ * \tparam TX TX pin
+ */
+template <uint8_t RX, uint8_t TX> class FrskyDPins : public FrskyD {
+  static_assert (RX != TX, "FrskyDPins: RX and TX must be different pins");
+
+  public:
+    /**
+     * \brief Class constructor (opens the line)
+     */
+    FrskyDPins () : FrskyD (_soft), _soft (RX, TX) {
+      this->mySerial = &this->_soft.serial;
+      this->_pinTx   = TX;
+      this->_soft.begin (FRSKY_D_SPEED);
+    }
+
+  private:
+    FrskyDSoftSerial _soft;           //!<transport (constructed after FrskyD, which only keeps its address)
 };
 
 /**
@@ -363,3 +463,5 @@ class FrskyD {
 /**
  * \example FrskyD_sniffer/FrskyD_sniffer.ino
  */
+
+#endif
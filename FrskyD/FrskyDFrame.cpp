@@ -0,0 +1,103 @@
+/**
+ * \file FrskyDFrame.cpp
+ */
+
+#include "FrskyDFrame.h"
+#include "FrskyD.h"
+
+/**
+ * \brief Frame constructor (called by FrskyDFrame)
+ * \param period period [ms]
+ * \param values storage of the values
+ * \param capacity size of values
+ */
+FrskyDFrameBase::FrskyDFrameBase (uint16_t period, FrskyDValue *values, uint8_t capacity) {
+    this->_period   = period;
+    this->_values   = values;
+    this->_capacity = capacity;
+}
+
+/**
+ * An empty frame is never due. A frame that was never sent is due as soon as it holds a value.
+ * \brief Check if the frame must be sent
+ * \param now time [ms] (ex. millis())
+ * \return true if the period is over
+ */
+bool FrskyDFrameBase::due (unsigned long now) const {
+    if (this->_count == 0) return false;
+    if (!this->_sent)      return true;
+    return now - this->_sentAt >= this->_period;
+}
+
+/**
+ * The value replaces the previous one of the same ID (for \ref FRSKY_D_CELL_VOLT, of the same ID and cell ID). A new
+ * ID is added at the end of the frame.
+ * \brief Set a value
+ * \param id sensor ID
+ * \param val preformated value
+ * \return false if the frame is full
+ */
+bool FrskyDFrameBase::set (uint8_t id, int16_t val) {
+    uint8_t i;
+
+    for (i=0; i<this->_count; i++) {
+        if (this->_values[i].id != id) continue;
+        if (id == FRSKY_D_CELL_VOLT && ((this->_values[i].val ^ val) & 0x00f0)) continue;   // other cell
+        this->_values[i].val = val;
+        return true;
+    }
+
+    if (this->_count == this->_capacity) return false;
+    this->_values[this->_count].id  = id;
+    this->_values[this->_count].val = val;
+    this->_count++;
+    return true;
+}
+
+/**
+ * \brief Set a lipo cell voltage from millivolts, without any float (same encoding as FrskyD::sendCellMv())
+ * \param id cell ID
+ * \param mv voltage [mV]
+ * \return false if the frame is full
+ */
+bool FrskyDFrameBase::setCellMv (uint8_t id, uint16_t mv) {
+    return this->set (FRSKY_D_CELL_VOLT, FrskyD::cellValue (id, mv));
+}
+
+/**
+ * \brief Set a lipo cell voltage (same encoding as FrskyD::sendCellVolt())
+ * \param id cell ID
+ * \param val voltage
+ * \return false if the frame is full
+ */
+bool FrskyDFrameBase::setCellVolt (uint8_t id, float val) {
+    return this->set (FRSKY_D_CELL_VOLT, FrskyD::cellValue (id, val * 1000));
+}
+
+/**
+ * \brief Set a fixed-point value as 2 values, without any float (same encoding as FrskyD::sendFixed())
+ * \param idb ID B (before ".")
+ * \param ida ID A (after ".")
+ * \param val value * 100
+ * \return false if the frame is full
+ */
+bool FrskyDFrameBase::setFixed (uint8_t idb, uint8_t ida, int32_t val) {
+    int16_t  bp = val / 100;
+    uint16_t ap = (val < 0 ? -val : val) % 100;
+    return this->set (idb, bp) && this->set (ida, ap);
+}
+
+/**
+ * \brief Set a float as 2 values (same encoding as FrskyD::sendFloat())
+ * \param idb ID B (before ".")
+ * \param ida ID A (after ".")
+ * \param val value
+ * \return false if the frame is full
+ */
+bool FrskyDFrameBase::setFloat (uint8_t idb, uint8_t ida, float val) {
+    int16_t  bp = (int16_t) val;
+    uint16_t ap;
+    if (val >= 0) ap = (val - bp) * 100;
+    else          ap = (bp - val) * 100;
+    return this->set (idb, bp) && this->set (ida, ap);
+}
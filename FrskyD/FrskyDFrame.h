@@ -0,0 +1,93 @@
+/**
+ * \file FrskyDFrame.h
+ */
+
+#ifndef FrskyDFrame_h
+#define FrskyDFrame_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * \brief Period of the hub frame 1 [ms] - accelerometers, altitude, temperature, voltage, current, rpm
+ */
+#define FRSKY_D_FRAME1_PERIOD    200
+
+/**
+ * \brief Period of the hub frame 2 [ms] - GPS (except date and time), fuel level
+ */
+#define FRSKY_D_FRAME2_PERIOD    1000
+
+/**
+ * \brief Period of the hub frame 3 [ms] - GPS date and time
+ */
+#define FRSKY_D_FRAME3_PERIOD    5000
+
+/**
+ * \brief Value held by a frame (see FrskyDFrame)
+ */
+struct FrskyDValue {
+    uint8_t id;                                                     //!<sensor ID
+    int16_t val;                                                    //!<preformated value
+};
+
+/**
+ * Storage-independent part of FrskyDFrame - FrskyD only knows this one. Use FrskyDFrame in the sketches.
+ * \brief Frame of values, sent periodically as a single burst
+ */
+class FrskyDFrameBase {
+    friend class FrskyD;
+
+    public:
+        uint8_t  count () const         { return this->_count; }                    //!<number of values held
+        bool     due (unsigned long now) const;
+        uint16_t period () const        { return this->_period; }                   //!<period [ms]
+        bool     set (uint8_t id, int16_t val);
+        bool     setCellMv (uint8_t id, uint16_t mv);
+        bool     setCellVolt (uint8_t id, float val);
+        bool     setFixed (uint8_t idb, uint8_t ida, int32_t val);
+        bool     setFloat (uint8_t idb, uint8_t ida, float val);
+
+    protected:
+        FrskyDFrameBase (uint16_t period, FrskyDValue *values, uint8_t capacity);
+
+    private:
+        FrskyDValue      *_values;                                  //!<values, in the order they were first set
+        uint8_t           _capacity;                                //!<size of _values
+        uint8_t           _count = 0;                               //!<number of values held
+        uint16_t          _period;                                  //!<period [ms]
+        unsigned long     _sentAt = 0;                              //!<time of the last sending [ms]
+        bool              _sent = false;                            //!<true once sent
+        bool              _txBusy = false;                          //!<sending started, not finished (queue full)
+        uint8_t           _txNext = 0;                              //!<next value to send
+        FrskyDFrameBase  *_next = NULL;                             //!<next frame attached to the same FrskyD
+};
+
+/**
+ * The hub does not send a value when it changes, but groups them in 3 frames, each one sent on its own period (see
+ * \ref index). A frame reproduces that: the values are set whenever they change (the last value of an ID replaces the
+ * previous one), and the whole frame is encoded in one buffer and sent in one burst when its period is over.
+ *
+ * ~~~~~
+ * FrskyDFrame<4> frame3 (FRSKY_D_FRAME3_PERIOD);   // room for 4 values
+ *
+ * FrskyD.attach (&frame3);
+ * frame3.set (FRSKY_D_GPS_DM, 10 << 8 | 12);       // whenever the value changes
+ * FrskyD.update ();                                // from loop() - sends the frames that are due
+ * ~~~~~
+ *
+ * \brief Frame of N values, sent periodically as a single burst
+ */
+template <uint8_t N> class FrskyDFrame : public FrskyDFrameBase {
+    public:
+        /**
+         * \brief Frame constructor (empty - nothing is sent until a value is set)
+         * \param period period [ms] (ex. FRSKY_D_FRAME1_PERIOD)
+         */
+        FrskyDFrame (uint16_t period) : FrskyDFrameBase (period, this->_store, N) {}
+
+    private:
+        FrskyDValue _store[N];                                      //!<storage of the values
+};
+
+#endif
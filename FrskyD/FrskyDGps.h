@@ -0,0 +1,29 @@
+/**
+ * \file FrskyDGps.h
+ */
+
+#ifndef FrskyDGps_h
+#define FrskyDGps_h
+
+#include <stdint.h>
+
+/**
+ * A coordinate from FrskyD::decodeGps() takes 20 bytes at most ("180d 59m 59.9940s W"), any FrskyDGps 22 bytes.
+ * \brief Buffer size needed by FrskyD::formatGps() ("255d 255m 393.2100s W" and the final null)
+ */
+#define FRSKY_D_GPS_FORMAT_SIZE  22
+
+/**
+ * A GPS coordinate is sent as ddmm (B packet) and mmmm (A packet), that is ddmm.mmmm: degrees, minutes and 1/10000
+ * minutes. The hemisphere is sent apart (\ref FRSKY_D_GPS_LAT_NS, \ref FRSKY_D_GPS_LONG_EW). Decoding it takes no
+ * float and no String: see FrskyD::decodeGps() and FrskyD::formatGps().
+ * \brief Decoded GPS coordinate (latitude or longitude)
+ */
+struct FrskyDGps {
+    uint8_t  deg;                       //!<degrees (0~180)
+    uint8_t  min;                       //!<minutes (0~59)
+    uint16_t frac;                      //!<1/10000 minutes (0~9999)
+    char     hemisphere;                //!<'N', 'S', 'E' or 'W' (0 if unknown)
+};
+
+#endif
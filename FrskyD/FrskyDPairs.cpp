@@ -0,0 +1,159 @@
+/**
+ * \file FrskyDPairs.cpp
+ */
+
+#include "FrskyDPairs.h"
+#include "FrskyD.h"
+
+#define _barrier() __asm__ __volatile__ ("" ::: "memory")  // keep the buffer accesses between the sequence accesses
+
+static const uint8_t _idB[FRSKY_D_PAIRS] = {FRSKY_D_ALT_B, FRSKY_D_GPS_ALT_B, FRSKY_D_GPS_SPEED_B, FRSKY_D_GPS_COURSE_B,
+                                            FRSKY_D_GPS_LAT_B, FRSKY_D_GPS_LONG_B, FRSKY_D_VOLTAGE_B};
+static const uint8_t _idA[FRSKY_D_PAIRS] = {FRSKY_D_ALT_A, FRSKY_D_GPS_ALT_A, FRSKY_D_GPS_SPEED_A, FRSKY_D_GPS_COURSE_A,
+                                            FRSKY_D_GPS_LAT_A, FRSKY_D_GPS_LONG_A, FRSKY_D_VOLTAGE_A};
+
+/**
+ * Give it every decoded packet (ex. from the FrskyD::onValue() handler) - the packets that are not half of a pair are
+ * only counted.
+ * \brief Feed the tracker with one packet
+ * \param id sensor ID
+ * \param val value (see FrskyD::decodeInt())
+ * \return B ID of the pair published by this packet, 0 if none
+ */
+uint8_t FrskyDPairs::feed (uint8_t id, int16_t val) {
+    int8_t  i;
+    uint8_t seq;
+
+    this->_packets++;
+    if ((this->_packets & (FRSKY_D_PAIR_WINDOW - 1)) == 0) this->_expire ();
+    if (id == FRSKY_D_GPS_LAT_NS)  this->_ns = val;
+    if (id == FRSKY_D_GPS_LONG_EW) this->_ew = val;
+    if ((i = FrskyDPairs::index (id)) < 0) return 0;
+
+    if (id == _idB[i]) {
+        this->_pendingB[i]  = val;
+        this->_pendingAt[i] = this->_packets;
+        this->_pending |= 1 << i;
+        return 0;
+    }
+
+    if (!(this->_pending & 1 << i) || (uint8_t) (this->_packets - this->_pendingAt[i]) > FRSKY_D_PAIR_WINDOW) {
+        this->_pending &= ~(1 << i);
+        this->_dropped++;                   // no B, or a stale one
+        return 0;
+    }
+    this->_pending &= ~(1 << i);
+
+    seq = this->_seq[i] + 1;
+    if (seq == 0) seq = 2;                  // 0 means "never published", and the buffer parity must be kept
+    this->_b[i][seq & 1] = this->_pendingB[i];
+    this->_a[i][seq & 1] = val;
+    _barrier ();
+    this->_seq[i] = seq;                    // publish
+    return _idB[i];
+}
+
+/**
+ * \brief Feed the tracker with one packet, as received
+ * \param id sensor ID
+ * \param buffer packet data (2 bytes, see FrskyD::decodeInt())
+ * \return B ID of the pair published by this packet, 0 if none
+ */
+uint8_t FrskyDPairs::feed (uint8_t id, uint8_t *buffer) {
+    return this->feed (id, FrskyD::decodeInt (buffer));
+}
+
+/**
+ * \brief Last GPS coordinate published, with its hemisphere (see FrskyD::decodeGps())
+ * \param idb \ref FRSKY_D_GPS_LAT_B or \ref FRSKY_D_GPS_LONG_B
+ * \return coordinate (all 0 if never published)
+ */
+FrskyDGps FrskyDPairs::gps (uint8_t idb) const {
+    int16_t  bp = 0;
+    uint16_t ap = 0;
+
+    this->read (idb, &bp, &ap);
+    return FrskyD::decodeGps (bp, ap, idb == FRSKY_D_GPS_LAT_B ? this->_ns : this->_ew);
+}
+
+/**
+ * \brief Pair index of a sensor ID
+ * \param id B or A sensor ID
+ * \return index (0 ~ \ref FRSKY_D_PAIRS - 1), -1 if the ID is not half of a pair
+ */
+int8_t FrskyDPairs::index (uint8_t id) {
+    int8_t i;
+
+    for (i=0; i<FRSKY_D_PAIRS; i++) {
+        if (id == _idB[i] || id == _idA[i]) return i;
+    }
+    return -1;
+}
+
+/**
+ * \brief Read the last pair published
+ * \param idb B ID of the pair (ex. \ref FRSKY_D_ALT_B)
+ * \param bp value B (before ".")
+ * \param ap value A (after ".")
+ * \return sequence number of the pair (0 if never published, or if idb is not a pair - bp and ap are then not set)
+ */
+uint8_t FrskyDPairs::read (uint8_t idb, int16_t *bp, uint16_t *ap) const {
+    int8_t  i = FrskyDPairs::index (idb);
+    uint8_t seq;
+
+    if (i < 0 || this->_seq[i] == 0) return 0;
+    do {
+        seq = this->_seq[i];
+        _barrier ();
+        *bp = this->_b[i][seq & 1];
+        *ap = this->_a[i][seq & 1];
+        _barrier ();
+    } while ((uint8_t) (this->_seq[i] - seq) >= 2);    // the buffer was reused while reading
+    return seq;
+}
+
+/**
+ * Same as value(), without any float.
+ * \brief Value of the last pair published, fixed-point
+ * \param idb B ID of the pair (ex. \ref FRSKY_D_ALT_B)
+ * \return value * 100 (GPS coordinates: ddmmmmmm, value * 10000), 0 if never published
+ */
+int32_t FrskyDPairs::fixed (uint8_t idb) const {
+    int16_t  bp;
+    uint16_t ap;
+
+    if (!this->read (idb, &bp, &ap)) return 0;
+    if (idb == FRSKY_D_VOLTAGE_B) return ((int32_t) bp * 10 + ap) * 210 / 11;
+    if (idb == FRSKY_D_GPS_LAT_B || idb == FRSKY_D_GPS_LONG_B) return (int32_t) bp * 10000 + ap;
+    return FrskyD::calcFixed (bp, ap);
+}
+
+/**
+ * \ref FRSKY_D_VOLTAGE_B uses its own formula, GPS coordinates are returned as ddmm.mmmm (see FrskyD::decodeGpsLat()),
+ * the others are decoded by FrskyD::calcFloat().
+ * \brief Value of the last pair published
+ * \param idb B ID of the pair (ex. \ref FRSKY_D_ALT_B)
+ * \return value, 0 if never published
+ */
+float FrskyDPairs::value (uint8_t idb) const {
+    int16_t  bp;
+    uint16_t ap;
+
+    if (!this->read (idb, &bp, &ap)) return 0;
+    if (idb == FRSKY_D_VOLTAGE_B) return (float) (bp * 10 + ap) * 21 / 110;
+    if (idb == FRSKY_D_GPS_LAT_B || idb == FRSKY_D_GPS_LONG_B) return (float) bp + (float) ap / 10000.0;
+    return FrskyD::calcFloat (bp, ap);
+}
+
+/**
+ * Called every \ref FRSKY_D_PAIR_WINDOW packets, so that a stale B packet cannot look fresh when the packet counter
+ * wraps.
+ * \brief Forget the B packets that are too old
+ */
+void FrskyDPairs::_expire () {
+    int8_t i;
+
+    for (i=0; i<FRSKY_D_PAIRS; i++) {
+        if ((uint8_t) (this->_packets - this->_pendingAt[i]) > FRSKY_D_PAIR_WINDOW) this->_pending &= ~(1 << i);
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * \file FrskyDPairs.h
+ */
+
+#ifndef FrskyDPairs_h
+#define FrskyDPairs_h
+
+#include <stdint.h>
+#include "FrskyDGps.h"
+
+/**
+ * \brief Number of B/A pairs (see FrskyDPairs)
+ */
+#define FRSKY_D_PAIRS        7
+
+/**
+ * A B packet that is older is stale. Must be a power of 2.
+ * \brief Maximum distance between a B packet and its A packet [packets]
+ */
+#define FRSKY_D_PAIR_WINDOW  32
+
+/**
+ * Some values are sent as 2 packets: B (before ".") then A (after "."). Decoding each half on its own can pair an A
+ * with the B of another value (a lost packet, or a B from an earlier frame). The tracker only publishes a value when
+ * an A packet follows its B packet, within \ref FRSKY_D_PAIR_WINDOW packets:
+ * * an A packet without a fresh B packet is dropped (see dropped()),
+ * * a B packet replaces the previous one, if it was not followed by its A packet yet.
+ *
+ * The pairs are: \ref FRSKY_D_ALT_B, \ref FRSKY_D_GPS_ALT_B, \ref FRSKY_D_GPS_SPEED_B, \ref FRSKY_D_GPS_COURSE_B,
+ * \ref FRSKY_D_GPS_LAT_B, \ref FRSKY_D_GPS_LONG_B and \ref FRSKY_D_VOLTAGE_B. A pair is known by its B ID.
+ *
+ * The hemispheres (\ref FRSKY_D_GPS_LAT_NS, \ref FRSKY_D_GPS_LONG_EW) are kept as well, for gps().
+ *
+ * Like FrskySPSlot, each pair is double-buffered with a sequence number: read() never returns the B of one pair and
+ * the A of another, even if feed() is called from an interrupt.
+ *
+ * ~~~~~
+ * FrskyDPairs pairs;
+ *
+ * void onValue (uint8_t id, int16_t val) {                    // see FrskyD::onValue()
+ *   if (pairs.feed (id, val) == FRSKY_D_ALT_B) alt = pairs.value (FRSKY_D_ALT_B);
+ * }
+ * ~~~~~
+ *
+ * \brief B/A pair reassembly (FrskyD)
+ */
+class FrskyDPairs {
+    public:
+        uint16_t dropped () const       { return this->_dropped; }                  //!<number of A packets dropped
+        uint8_t  feed (uint8_t id, int16_t val);
+        uint8_t  feed (uint8_t id, uint8_t *buffer);
+        uint8_t  read (uint8_t idb, int16_t *bp, uint16_t *ap) const;
+        int32_t  fixed (uint8_t idb) const;
+        FrskyDGps gps (uint8_t idb) const;
+        float    value (uint8_t idb) const;
+
+        static int8_t index (uint8_t id);
+
+    private:
+        void     _expire ();
+
+        int16_t           _b[FRSKY_D_PAIRS][2];                     //!<B values, _b[i][_seq[i] & 1] is the last one
+        uint16_t          _a[FRSKY_D_PAIRS][2];                     //!<A values, same
+        volatile uint8_t  _seq[FRSKY_D_PAIRS] = {};                 //!<incremented by each pair published (0 = never)
+        int16_t           _pendingB[FRSKY_D_PAIRS];                 //!<B values waiting for their A
+        uint8_t           _pendingAt[FRSKY_D_PAIRS];                //!<_packets when the B value was received
+        uint8_t           _pending = 0;                             //!<bit i: _pendingB[i] is set
+        uint8_t           _packets = 0;                             //!<packets fed (wraps)
+        uint16_t          _dropped = 0;                             //!<see dropped()
+        char              _ns = 0;                                  //!<last \ref FRSKY_D_GPS_LAT_NS value
+        char              _ew = 0;                                  //!<last \ref FRSKY_D_GPS_LONG_EW value
+};
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * \file FrskyDSensors.cpp
+ */
+
+#include "FrskyD.h"
+
+constexpr FrskyDSensor FrskyDSensors::table[];
+
+static_assert (FrskyDSensors::pairs () == FRSKY_D_PAIRS, "FRSKY_D_PAIRS does not match the pairs of FrskyDSensors");
+
+/**
+ * \brief Row of an ID, at runtime (binary search)
+ * \param id sensor ID
+ * \return row, NULL if the ID is unknown
+ */
+const FrskyDSensor *FrskyDSensors::lookup (uint8_t id) {
+    uint8_t lo = 0, hi = count, mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (id < table[mid].id)      hi = mid;
+        else if (id > table[mid].id) lo = mid + 1;
+        else return &table[mid];
+    }
+    return NULL;
+}
+
+/**
+ * format              | result
+ * ------------------- | -------------------------------------------------------
+ * FRSKY_D_FORMAT_INT  | quantity (value / scale)
+ * FRSKY_D_FORMAT_CELL | cell voltage (see FrskyD::decodeCellVolt())
+ * other               | value as is (see FrskyDPairs for the B/A pairs)
+ *
+ * \brief Decode a received value with its row (see FrskyDCodec to decode at compile time)
+ * \param sensor row (see lookup())
+ * \param val received value (see FrskyD::onValue())
+ * \return quantity (unit of the row)
+ */
+float FrskyDSensors::value (const FrskyDSensor &sensor, int16_t val) {
+    switch (sensor.format) {
+        case FRSKY_D_FORMAT_INT:
+            return sensor.isSigned ? (float) val / sensor.scale : (float) (uint16_t) val / sensor.scale;
+        case FRSKY_D_FORMAT_CELL:
+            return (float) ((val & 0x0f) << 8 | (uint16_t) val >> 8) / sensor.scale;   // bytes swapped
+    }
+    return val;
+}
@@ -0,0 +1,167 @@
+/**
+ * \file FrskyDSensors.h
+ */
+
+#ifndef FrskyDSensors_h
+#define FrskyDSensors_h
+
+#include <stdint.h>
+
+#define FRSKY_D_FORMAT_INT      0           //!<integer: value = quantity * scale
+#define FRSKY_D_FORMAT_B        1           //!<part before "." of a B/A pair (see FrskyDPairs)
+#define FRSKY_D_FORMAT_A        2           //!<part after "." of a B/A pair
+#define FRSKY_D_FORMAT_CELL     3           //!<lipo cell (see FrskyD::decodeCellVolt())
+#define FRSKY_D_FORMAT_BYTES    4           //!<2 bytes (see FrskyD::decode1Int())
+#define FRSKY_D_FORMAT_CHAR     5           //!<one character (GPS hemisphere)
+
+/**
+ * \brief Descriptor of a D sensor ID (see FrskyDSensors)
+ */
+struct FrskyDSensor {
+    uint8_t     id;                         //!<sensor ID
+    uint8_t     pair;                       //!<other half of a B/A pair (0 if none)
+    uint16_t    scale;                      //!<value = quantity * scale (FRSKY_D_FORMAT_INT, FRSKY_D_FORMAT_CELL)
+    bool        isSigned;                   //!<the value is signed
+    uint8_t     format;                     //!<FRSKY_D_FORMAT_INT ~ FRSKY_D_FORMAT_CHAR
+    const char *name;                       //!<short name
+    const char *unit;                       //!<unit of the quantity ("" if none)
+};
+
+/**
+ * The IDs are documented one by one in FrskyD.h - this table holds the same, in a form the code can use: B/A
+ * pairing, scale, unit and signedness. It is sorted by ID (checked when compiling): adding a sensor is adding its
+ * row.
+ *
+ * At compile time, FrskyDCodec gives the encoder and the decoder of one ID. At runtime (ex. in a sniffer), lookup()
+ * finds the row of any ID with a binary search, and value() decodes it.
+ *
+ * \brief D sensor table
+ */
+class FrskyDSensors {
+    public:
+        static constexpr FrskyDSensor table[] = {
+            //  ID                  pair                  scale signed format                name       unit
+            {FRSKY_D_GPS_ALT_B,     FRSKY_D_GPS_ALT_A,    1,    true,  FRSKY_D_FORMAT_B,     "GAlt",    "m"},
+            {FRSKY_D_TEMP1,         0,                    1,    true,  FRSKY_D_FORMAT_INT,   "Temp1",   "C"},
+            {FRSKY_D_RPM,           0,                    1,    false, FRSKY_D_FORMAT_INT,   "Rpm",     "rpm"},
+            {FRSKY_D_FUEL,          0,                    1,    false, FRSKY_D_FORMAT_INT,   "Fuel",    "%"},
+            {FRSKY_D_TEMP2,         0,                    1,    true,  FRSKY_D_FORMAT_INT,   "Temp2",   "C"},
+            {FRSKY_D_CELL_VOLT,     0,                    500,  false, FRSKY_D_FORMAT_CELL,  "CellV",   "V"},
+            {FRSKY_D_GPS_ALT_A,     FRSKY_D_GPS_ALT_B,    1,    false, FRSKY_D_FORMAT_A,     "GAlt",    "m"},
+            {FRSKY_D_ALT_B,         FRSKY_D_ALT_A,        1,    true,  FRSKY_D_FORMAT_B,     "Alt",     "m"},
+            {FRSKY_D_GPS_SPEED_B,   FRSKY_D_GPS_SPEED_A,  1,    true,  FRSKY_D_FORMAT_B,     "GSpd",    "knots"},
+            {FRSKY_D_GPS_LONG_B,    FRSKY_D_GPS_LONG_A,   1,    true,  FRSKY_D_FORMAT_B,     "GLong",   "ddmm"},
+            {FRSKY_D_GPS_LAT_B,     FRSKY_D_GPS_LAT_A,    1,    true,  FRSKY_D_FORMAT_B,     "GLat",    "ddmm"},
+            {FRSKY_D_GPS_COURSE_B,  FRSKY_D_GPS_COURSE_A, 1,    true,  FRSKY_D_FORMAT_B,     "Hdg",     "deg"},
+            {FRSKY_D_GPS_DM,        0,                    1,    false, FRSKY_D_FORMAT_BYTES, "DayMon",  ""},
+            {FRSKY_D_GPS_YEAR,      0,                    1,    false, FRSKY_D_FORMAT_BYTES, "Year",    ""},
+            {FRSKY_D_GPS_HM,        0,                    1,    false, FRSKY_D_FORMAT_BYTES, "HourMin", ""},
+            {FRSKY_D_GPS_SEC,       0,                    1,    false, FRSKY_D_FORMAT_BYTES, "Sec",     ""},
+            {FRSKY_D_GPS_SPEED_A,   FRSKY_D_GPS_SPEED_B,  1,    false, FRSKY_D_FORMAT_A,     "GSpd",    "knots"},
+            {FRSKY_D_GPS_LONG_A,    FRSKY_D_GPS_LONG_B,   1,    false, FRSKY_D_FORMAT_A,     "GLong",   "ddmm"},
+            {FRSKY_D_GPS_LAT_A,     FRSKY_D_GPS_LAT_B,    1,    false, FRSKY_D_FORMAT_A,     "GLat",    "ddmm"},
+            {FRSKY_D_GPS_COURSE_A,  FRSKY_D_GPS_COURSE_B, 1,    false, FRSKY_D_FORMAT_A,     "Hdg",     "deg"},
+            {FRSKY_D_ALT_A,         FRSKY_D_ALT_B,        1,    false, FRSKY_D_FORMAT_A,     "Alt",     "m"},
+            {FRSKY_D_GPS_LONG_EW,   0,                    1,    false, FRSKY_D_FORMAT_CHAR,  "GLongEW", ""},
+            {FRSKY_D_GPS_LAT_NS,    0,                    1,    false, FRSKY_D_FORMAT_CHAR,  "GLatNS",  ""},
+            {FRSKY_D_ACCX,          0,                    1000, true,  FRSKY_D_FORMAT_INT,   "AccX",    "g"},
+            {FRSKY_D_ACCY,          0,                    1000, true,  FRSKY_D_FORMAT_INT,   "AccY",    "g"},
+            {FRSKY_D_ACCZ,          0,                    1000, true,  FRSKY_D_FORMAT_INT,   "AccZ",    "g"},
+            {FRSKY_D_CURRENT,       0,                    10,   true,  FRSKY_D_FORMAT_INT,   "Current", "A"},
+            {FRSKY_D_VFAS,          0,                    10,   true,  FRSKY_D_FORMAT_INT,   "VFAS",    "V"},
+            {FRSKY_D_VOLTAGE_B,     FRSKY_D_VOLTAGE_A,    1,    false, FRSKY_D_FORMAT_B,     "Voltage", "V"},
+            {FRSKY_D_VOLTAGE_A,     FRSKY_D_VOLTAGE_B,    1,    false, FRSKY_D_FORMAT_A,     "Voltage", "V"},
+        };
+
+        static constexpr uint8_t count = sizeof (table) / sizeof (table[0]);   //!<number of rows
+
+        /**
+         * \brief Row of an ID, at compile time
+         * \param id sensor ID
+         * \param i first row to check
+         * \return row index, count if the ID is unknown
+         */
+        static constexpr uint8_t find (uint8_t id, uint8_t i = 0) {
+            return i >= count ? count : table[i].id == id ? i : find (id, i + 1);
+        }
+
+        /**
+         * \brief Number of B/A pairs in the table
+         */
+        static constexpr uint8_t pairs (uint8_t i = 0) {
+            return i >= count ? 0 : (table[i].format == FRSKY_D_FORMAT_B) + pairs (i + 1);
+        }
+
+        /**
+         * \brief Check the table order, and that each half of a pair points to the other
+         */
+        static constexpr bool valid (uint8_t i = 0) {
+            return i >= count ? true
+                 : (i == 0 || table[i - 1].id < table[i].id)
+                   && (table[i].pair == 0 || (find (table[i].pair) < count && table[find (table[i].pair)].pair == table[i].id))
+                   && valid (i + 1);
+        }
+
+        static const FrskyDSensor *lookup (uint8_t id);
+        static float               value (const FrskyDSensor &sensor, int16_t val);
+};
+
+static_assert (FrskyDSensors::valid (), "FrskyDSensors::table must be sorted by ID, with matching B/A pairs");
+
+/**
+ * Encoder and decoder of an integer ID (FRSKY_D_FORMAT_INT), from its row in FrskyDSensors: the scale is known when
+ * compiling, and an unknown ID does not compile. The input (or output) resolution must be a divisor or a multiple of
+ * the scale (checked when compiling): the conversion is then one integer multiplication or division.
+ * ~~~~~
+ * FrskyD.sendData (FRSKY_D_VFAS, FrskyDCodec<FRSKY_D_VFAS>::encode<1000> (mv));    // V * 10: mV / 100
+ * ~~~~~
+ *
+ * \brief Compile-time sensor codec (D)
+ * \tparam ID sensor ID
+ */
+template <uint8_t ID> class FrskyDCodec {
+    public:
+        static constexpr uint8_t  index    = FrskyDSensors::find (ID);          //!<row in FrskyDSensors::table
+        static_assert (index < FrskyDSensors::count, "unknown ID: add it to FrskyDSensors::table");
+
+        static constexpr uint16_t scale    = FrskyDSensors::table[index].scale;     //!<value = quantity * scale
+        static constexpr bool     isSigned = FrskyDSensors::table[index].isSigned;  //!<signed value
+
+        /**
+         * \brief Encode a quantity given in 1/DIV units, truncated toward 0
+         * \tparam DIV input resolution (ex. 1000 for mV, when the unit is V) - a divisor or a multiple of the scale
+         * \param val quantity * DIV
+         * \return value to send
+         */
+        template <uint32_t DIV = 1> static int16_t encode (int32_t val) {
+            static_assert (FrskyDSensors::table[index].format == FRSKY_D_FORMAT_INT, "not an integer ID");
+            static_assert (scale % DIV == 0 || DIV % scale == 0, "scale and DIV do not divide evenly");
+            return scale % DIV == 0 ? val * (int32_t) (scale / DIV) : val / (int32_t) (DIV / scale);
+        }
+
+        /**
+         * \brief Decode a received value, in 1/MUL units, truncated toward 0
+         * \tparam MUL output resolution (ex. 1000 for mV, when the unit is V) - a divisor or a multiple of the scale
+         * \param val received value (see FrskyD::onValue())
+         * \return quantity * MUL
+         */
+        template <uint32_t MUL = 1> static int32_t decode (int16_t val) {
+            static_assert (FrskyDSensors::table[index].format == FRSKY_D_FORMAT_INT, "not an integer ID");
+            static_assert (MUL % scale == 0 || scale % MUL == 0, "scale and MUL do not divide evenly");
+            return MUL % scale == 0 ? _value (val) * (int32_t) (MUL / scale) : _value (val) / (int32_t) (scale / MUL);
+        }
+
+        /**
+         * \brief Decode a received value
+         * \param val received value (see FrskyD::onValue())
+         * \return quantity (unit of the table)
+         */
+        static float decodeFloat (int16_t val) {
+            return (float) _value (val) / scale;
+        }
+
+    private:
+        static int32_t _value (int16_t val) { return isSigned ? (int32_t) val : (int32_t) (uint16_t) val; }
+};
+
+#endif
@@ -0,0 +1,38 @@
+/**
+ * \file FrskyDStats.h
+ */
+
+#ifndef FrskyDStats_h
+#define FrskyDStats_h
+
+#include <stdint.h>
+
+/**
+ * Link quality counters, kept by FrskyD. All the counters saturate at 65535: take a snapshot with FrskyD::stats(),
+ * and clear them with FrskyD::statsReset(), ex. once per minute.
+ *
+ * ~~~~~
+ * FrskyDStats s = FrskyD.stats ();
+ * FrskyD.statsReset ();
+ * if (s.dropped) Serial.println ("broken packets");
+ * ~~~~~
+ *
+ * \brief Bus health counters (D)
+ */
+struct FrskyDStats {
+    uint16_t packets;                       //!<packets decoded by feed()
+    uint16_t sent;                          //!<writes: packets, or bursts of a frame (see FrskyD::send()), sent or queued
+    uint16_t overflows;                     //!<RX buffer overflows (see FrskyDTransport), writes refused by a full queue
+    uint16_t unstuffed;                     //!<exceptions decoded (0x5D 0x3E, 0x5D 0x3D)
+    uint16_t dropped;                       //!<packets dropped: cut by a header, or with a bad exception
+
+    /**
+     * \brief Saturating increment
+     * \param counter counter
+     */
+    static void count (uint16_t &counter) {
+        if (counter != 0xffff) counter++;
+    }
+};
+
+#endif
@@ -0,0 +1,34 @@
+/**
+ * \file FrskyDTimer2.h
+ */
+
+#ifndef FrskyDTimer2_h
+#define FrskyDTimer2_h
+
+#include "FrskyDTxQueue.h"
+
+/**
+ * Include it in the sketch (the .ino, once) to drive the line of FrskyD::async() with the Timer2 interrupt, one bit
+ * per interrupt, instead of one byte per FrskyD::update(). It defines the interrupt handler, then Timer2 cannot be
+ * used by anything else in the sketch (tone(), FreqCount, MsTimer2) - see the warning of FrskyDTxQueue.
+ * ~~~~~
+ * #include <FrskyD.h>
+ * #include <FrskyDTimer2.h>
+ *
+ * void setup () {
+ *   FrskyD.async ();
+ * }
+ * ~~~~~
+ * Elsewhere than on AVR, it does nothing: the queue is drained by FrskyD::update().
+ *
+ * \brief Timer2 drive of the FrskyD transmit queue (opt-in)
+ */
+#ifdef FRSKY_D_TX_TIMER2
+ISR (TIMER2_COMPA_vect) {
+    FrskyDTxQueue::timer2Tick ();
+}
+#endif
+
+static const bool frskyDTimer2 = FrskyDTxQueue::timer2 ();     //!<set before setup() (and FrskyD::async()) runs
+
+#endif
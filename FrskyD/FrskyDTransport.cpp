@@ -0,0 +1,122 @@
+/**
+ * \file FrskyDTransport.cpp
+ */
+
+#include "FrskyDTransport.h"
+
+#ifdef FRSKY_D_TERMIOS
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/**
+ * \brief termios speed constant of a speed
+ * \param speed speed [bds]
+ * \return speed constant (B0 if unknown)
+ */
+static speed_t _baud (long speed) {
+    switch (speed) {
+        case 9600:   return B9600;
+        case 19200:  return B19200;
+        case 38400:  return B38400;
+        case 57600:  return B57600;
+        case 115200: return B115200;
+    }
+    return B0;
+}
+
+/**
+ * The device is opened by begin().
+ * \brief Class constructor
+ * \param path device (ex. /dev/ttyUSB0, a pty slave, a fifo or a file)
+ */
+FrskyDTermios::FrskyDTermios (const char *path) {
+    this->_path = path;
+    this->_fd   = -1;
+}
+
+/**
+ * \brief Class constructor, on an open file descriptor (ex. a pty master, or stdin)
+ * \param fd file descriptor
+ */
+FrskyDTermios::FrskyDTermios (int fd) {
+    this->_path = NULL;
+    this->_fd   = fd;
+}
+
+/**
+ * \brief Number of bytes received, not read yet (never waits)
+ * \return number of bytes
+ */
+int FrskyDTermios::available () {
+    ssize_t n;
+
+    if (this->_fd >= 0 && this->_head == this->_tail) {
+        n = ::read (this->_fd, this->_buf, sizeof (this->_buf));
+        if (n <= 0) return 0;
+        this->_head = 0;
+        this->_tail = n;
+    }
+    return this->_tail - this->_head;
+}
+
+/**
+ * A terminal is set raw, 8N1, at the given speed. Anything else (pty master, pipe, file) is read as is. The latency
+ * timer of a USB adapter (/sys/bus/usb-serial/devices/<tty>/latency_timer) is reported by turnaround().
+ * \brief Open the line
+ * \param speed speed [bds]
+ */
+void FrskyDTermios::begin (long speed) {
+    struct termios tio;
+    char  sys[64];
+    FILE *f;
+    int   ms;
+
+    this->_speed = speed;
+    if (this->_fd < 0 && this->_path) {
+        this->_fd = open (this->_path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (this->_fd < 0) this->_fd = open (this->_path, O_RDONLY | O_NONBLOCK);
+        if (this->_fd < 0) return;
+    }
+    fcntl (this->_fd, F_SETFL, fcntl (this->_fd, F_GETFL) | O_NONBLOCK);
+
+    if (tcgetattr (this->_fd, &tio) == 0) {
+        cfmakeraw (&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cc[VMIN]  = 0;
+        tio.c_cc[VTIME] = 0;
+        if (_baud (speed) != B0) {
+            cfsetispeed (&tio, _baud (speed));
+            cfsetospeed (&tio, _baud (speed));
+        }
+        tcsetattr (this->_fd, TCSANOW, &tio);
+    }
+
+    if (!this->_path || !strrchr (this->_path, '/')) return;
+    snprintf (sys, sizeof (sys), "/sys/bus/usb-serial/devices/%s/latency_timer", strrchr (this->_path, '/') + 1);
+    if ((f = fopen (sys, "r")) == NULL) return;
+    if (fscanf (f, "%d", &ms) == 1 && ms >= 0 && ms <= 65) this->_turnaround = ms * 1000;
+    fclose (f);
+}
+
+/**
+ * \brief Next byte received (never waits)
+ * \return byte, -1 if none
+ */
+int FrskyDTermios::read () {
+    if (!this->available ()) return -1;
+    return this->_buf[this->_head++];
+}
+
+/**
+ * \brief Send a byte
+ * \param val byte
+ * \return 1 if written, 0 otherwise
+ */
+size_t FrskyDTermios::write (uint8_t val) {
+    if (this->_fd < 0 || ::write (this->_fd, &val, 1) != 1) return 0;
+    return 1;
+}
+#endif
@@ -0,0 +1,128 @@
+/**
+ * \file FrskyDTransport.h
+ */
+
+#ifndef FrskyDTransport_h
+#define FrskyDTransport_h
+
+#include "Arduino.h"
+#include "SoftwareSerial.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+#define FRSKY_D_TERMIOS                     //!<FrskyDTermios is available (Linux host build)
+#endif
+
+/**
+ * FrskyD only reaches the line through this interface: the protocol code is the same whatever drives the line.
+ *
+ * backend              | class                          | turnaround()
+ * -------------------- | ------------------------------ | ------------------------------------------------------
+ * SoftwareSerial       | FrskyDSoftSerial (default)     | 1 bit (the RX interrupt waits for the stop bit)
+ * hardware UART        | FrskyDSerial<HardwareSerial>   | 0
+ * AltSoftSerial        | FrskyDSerial<AltSoftSerial>    | 1 bit (the next timer compare starts the TX)
+ * Linux tty, pty, pipe | FrskyDTermios                  | USB adapter latency timer, 0 for a pty
+ *
+ * \brief Serial line under FrskyD (see FrskyD::FrskyD(FrskyDTransport&))
+ */
+class FrskyDTransport {
+    public:
+        virtual int      available () = 0;                          //!<number of bytes received, not read yet
+        virtual void     begin (long speed) = 0;                    //!<open the line (ex. \ref FRSKY_D_SPEED)
+        virtual int      read () = 0;                               //!<next byte received, -1 if none
+        virtual bool     overflow () { return false; }              //!<true once after received bytes were lost (buffer full)
+        virtual uint16_t turnaround () const = 0;                   //!<nominal delay before a byte written starts [µs]
+        virtual size_t   write (uint8_t val) = 0;                   //!<send a byte
+
+    protected:
+        long              _speed = 0;                               //!<speed [bds], set by begin()
+};
+
+/**
+ * SoftwareSerial, inverted. This is what FrskyD::FrskyD(int, int) uses.
+ * \brief SoftwareSerial transport (FrskyD)
+ */
+class FrskyDSoftSerial : public FrskyDTransport {
+    public:
+        /**
+         * \brief Class constructor
+         * \param pinRx RX pin
+         * \param pinTx TX pin
+         */
+        FrskyDSoftSerial (int pinRx, int pinTx) : serial (pinRx, pinTx, true) {}
+
+        int      available ()           { return this->serial.available (); }
+        void     begin (long speed)     { this->_speed = speed; this->serial.begin (speed); }
+        bool     overflow ()            { return this->serial.overflow (); }
+        int      read ()                { return this->serial.read (); }
+        uint16_t turnaround () const    { return this->_speed ? 1000000L / this->_speed : 0; }
+        size_t   write (uint8_t val)    { return this->serial.write (val); }
+
+        SoftwareSerial    serial;                                   //!<SoftwareSerial object
+};
+
+/**
+ * Any class with the HardwareSerial methods (begin, available, read, write), ex. Serial1 or
+ * [AltSoftSerial] (http://www.pjrc.com/teensy/td_libs_AltSoftSerial.html). Neither can invert the signal: an
+ * inverter is needed between the port and the line.
+ *
+ * ~~~~~
+ * FrskyDSerial<HardwareSerial> line (Serial1);
+ * FrskyD FrskyD (line);
+ *
+ * void setup () {
+ *   line.begin (FRSKY_D_SPEED);
+ * }
+ * ~~~~~
+ *
+ * \brief Transport on a serial port (FrskyD)
+ * \tparam S serial class
+ */
+template <class S> class FrskyDSerial : public FrskyDTransport {
+    public:
+        /**
+         * \brief Class constructor
+         * \param serial serial port
+         * \param startBits delay of the port before it starts sending [bit times] (0 for a UART, 1 for AltSoftSerial)
+         */
+        FrskyDSerial (S &serial, uint8_t startBits = 0) : _serial (serial), _startBits (startBits) {}
+
+        int      available ()           { return this->_serial.available (); }
+        void     begin (long speed)     { this->_speed = speed; this->_serial.begin (speed); }
+        int      read ()                { return this->_serial.read (); }
+        uint16_t turnaround () const    { return this->_speed ? this->_startBits * 1000000L / this->_speed : 0; }
+        size_t   write (uint8_t val)    { return this->_serial.write (val); }
+
+    private:
+        S                &_serial;                                  //!<serial port
+        uint8_t           _startBits;                               //!<see turnaround()
+};
+
+#ifdef FRSKY_D_TERMIOS
+/**
+ * Runs FrskyD on a Linux gateway: a serial adapter (ex. /dev/ttyUSB0, inverted - FTDI chips can invert in their
+ * EEPROM), a pty, a pipe or a file. The line is raw, non-blocking: available() never waits.
+ * \brief Linux termios transport (FrskyD, host only)
+ */
+class FrskyDTermios : public FrskyDTransport {
+    public:
+        FrskyDTermios (const char *path);
+        FrskyDTermios (int fd);
+
+        int      available ();
+        void     begin (long speed);
+        int      fd () const            { return this->_fd; }       //!<file descriptor (-1 if not open)
+        int      read ();
+        uint16_t turnaround () const    { return this->_turnaround; }
+        size_t   write (uint8_t val);
+
+    private:
+        const char       *_path;                                    //!<device path (NULL if opened by the caller)
+        int               _fd;                                      //!<file descriptor
+        uint16_t          _turnaround = 0;                          //!<see turnaround()
+        uint8_t           _buf[64];                                 //!<bytes read, not taken yet
+        uint8_t           _head = 0;                                //!<next byte to take in _buf
+        uint8_t           _tail = 0;                                //!<end of the bytes in _buf
+};
+#endif
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * \file FrskyDTxQueue.cpp
+ */
+
+#include "FrskyDTxQueue.h"
+
+#ifdef FRSKY_D_TX_TIMER2
+static FrskyDTxQueue *_active = NULL;    // queue drained by the interrupt
+static bool           _timer2 = false;  // the sketch defines the interrupt (see FrskyDTimer2.h)
+#endif
+
+/**
+ * On AVR, when the sketch includes FrskyDTimer2.h, the queue drives the TX pin itself, inverted as the D protocol is
+ * (idle LOW). There is one Timer2: only the first queue constructed is drained by the interrupt. The others, a queue
+ * without a TX pin, and all of them without FrskyDTimer2.h, are drained by FrskyD::update() (or FrskyD::step()),
+ * through the transport.
+ * \brief Class constructor
+ * \param pinTx TX pin (-1 = none)
+ * \param speed speed [bds] (ex. 9600)
+ */
+FrskyDTxQueue::FrskyDTxQueue (int pinTx, long speed) {
+#ifdef FRSKY_D_TX_TIMER2
+    if (pinTx < 0 || _active || !_timer2) return;
+    this->_port = portOutputRegister (digitalPinToPort (pinTx));
+    this->_mask = digitalPinToBitMask (pinTx);
+    this->_ocr  = F_CPU / 8 / speed - 1;
+    _active = this;
+#else
+    (void) pinTx;
+    (void) speed;
+#endif
+}
+
+/**
+ * \brief Check if the queue is drained by the Timer2 interrupt
+ * \return true on AVR with a TX pin and FrskyDTimer2.h, false if FrskyD::update() must drain it
+ */
+bool FrskyDTxQueue::interrupt () const {
+#ifdef FRSKY_D_TX_TIMER2
+    return this->_port != NULL;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Called by FrskyDTimer2.h, before any queue is constructed (FrskyD::async() is called from setup()).
+ * \brief Let the next queue constructed be drained by the Timer2 interrupt
+ * \return true on AVR with Timer2, false elsewhere (the queues are drained by FrskyD::update())
+ */
+bool FrskyDTxQueue::timer2 () {
+#ifdef FRSKY_D_TX_TIMER2
+    _timer2 = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * \brief Timer2 interrupt handler: drive the line of the queue that took Timer2 (see FrskyDTimer2.h)
+ */
+void FrskyDTxQueue::timer2Tick () {
+#ifdef FRSKY_D_TX_TIMER2
+    if (_active) _active->tick ();
+#endif
+}
+
+/**
+ * Called by the interrupt with FrskyDTimer2.h, by FrskyD::update() otherwise.
+ * \brief Take the next byte to send
+ * \return byte, or -1 if the queue is empty
+ */
+int FrskyDTxQueue::pop () {
+    uint8_t b;
+
+    if (this->_tail == this->_head) return -1;
+    b = this->_buf[this->_tail & (FRSKY_D_TX_QUEUE - 1)];
+    this->_tail = this->_tail + 1;
+    return b;
+}
+
+/**
+ * O(1) per byte, never waits: the packet is copied, and sent in the background.
+ * \brief Queue a packet
+ * \param buffer encoded packet (see FrskyD::encode())
+ * \param len number of bytes
+ * \return false if there is not enough room (nothing is queued, and the packet is counted in overflows())
+ */
+bool FrskyDTxQueue::push (const uint8_t *buffer, uint8_t len) {
+    uint8_t head = this->_head;
+    uint8_t i;
+
+    if (len > this->space ()) {
+        this->_overflows++;
+        return false;
+    }
+    for (i=0; i<len; i++) this->_buf[(uint8_t) (head + i) & (FRSKY_D_TX_QUEUE - 1)] = buffer[i];
+    this->_head = head + len;               // publish
+
+    if (this->pending () > this->_highWater) this->_highWater = this->pending ();
+    this->_start ();
+    return true;
+}
+
+/**
+ * Drives the line for one bit time: start bit, 8 data bits (LSB first), stop bit - inverted. When the stop bit is
+ * over, the next byte starts at once, or the interrupt is turned off if the queue is empty.
+ * \brief Timer2 interrupt handler (AVR only, does nothing elsewhere - see timer2Tick())
+ */
+void FrskyDTxQueue::tick () {
+#ifdef FRSKY_D_TX_TIMER2
+    int b;
+
+    if (this->_bit == 0 || this->_bit == 10) {
+        if ((b = this->pop ()) < 0) {
+            TIMSK2 &= ~_BV (OCIE2A);        // idle until the next push()
+            this->_bit = 0;
+            return;
+        }
+        this->_byte = b;
+        *this->_port |= this->_mask;        // start bit
+        this->_bit = 1;
+    }
+    else if (this->_bit <= 8) {
+        if (this->_byte & 1) *this->_port &= ~this->_mask;
+        else                 *this->_port |=  this->_mask;
+        this->_byte >>= 1;
+        this->_bit++;
+    }
+    else {
+        *this->_port &= ~this->_mask;       // stop bit
+        this->_bit = 10;
+    }
+#endif
+}
+
+/**
+ * Timer2 is set again each time (the Arduino core sets it for PWM at startup).
+ * \brief Turn the interrupt on, if not already (AVR only)
+ */
+void FrskyDTxQueue::_start () {
+#ifdef FRSKY_D_TX_TIMER2
+    if (!this->_port) return;               // drained by FrskyD::update()
+    if (TIMSK2 & _BV (OCIE2A)) return;      // already sending
+    TCCR2A = _BV (WGM21);                   // CTC
+    TCCR2B = _BV (CS21);                    // F_CPU / 8
+    OCR2A  = this->_ocr;
+    TCNT2  = 0;
+    TIFR2  = _BV (OCF2A);
+    TIMSK2 |= _BV (OCIE2A);
+#endif
+}
@@ -0,0 +1,73 @@
+/**
+ * \file FrskyDTxQueue.h
+ */
+
+#ifndef FrskyDTxQueue_h
+#define FrskyDTxQueue_h
+
+#include "Arduino.h"
+
+/**
+ * \brief Size of the transmit queue [bytes] (power of 2, 128 at most)
+ */
+#define FRSKY_D_TX_QUEUE     128
+
+#if defined(__AVR__) && defined(TIMER2_COMPA_vect)
+#define FRSKY_D_TX_TIMER2                   //!<the queue can be drained by the Timer2 interrupt (see FrskyDTimer2.h)
+#endif
+
+/**
+ * At 9600 bds, a byte takes about 1 ms. SoftwareSerial::write() waits for the whole byte (interrupts disabled), then a
+ * 12 cells burst stalls loop() for about 80 ms. With the queue (see FrskyD::async()), sending a packet only copies its
+ * bytes, and the line is driven in the background:
+ * * by FrskyD::update() (or FrskyD::step()), one byte per call, through the transport - the default,
+ * * on AVR, when the sketch includes FrskyDTimer2.h, by the Timer2 compare interrupt, one bit per interrupt - the
+ *   interrupt is off when the queue is empty.
+ *
+ * A packet is queued entirely or not at all (a truncated packet would corrupt the next one). When there is no room
+ * left, the packet is refused and counted (see overflows()): check space() first to wait instead.
+ *
+ * The Timer2 drive is opt-in, as the library would otherwise define the Timer2 interrupt in every sketch, and
+ * tone(), FreqCount or MsTimer2 could not be linked with it.
+ *
+ * \warning With FrskyDTimer2.h, Timer2 is taken (tone(), FreqCount and MsTimer2 cannot be used in the same sketch).
+ * The bits are timed by the interrupt, then anything that disables the interrupts for more than a few µs corrupts the
+ * byte being sent. SoftwareSerial does so for a whole byte each time it receives one (about 1 ms at 9600 bds, 170 µs
+ * at 57600 bds for a Smart Port bus on SoftwareSerial in the same sketch): the bit edges sent meanwhile are late.
+ *
+ * \brief Background transmit queue (FrskyD)
+ */
+class FrskyDTxQueue {
+    public:
+        FrskyDTxQueue (int pinTx, long speed);
+
+        uint8_t  highWater () const     { return this->_highWater; }                 //!<highest number of bytes pending
+        bool     interrupt () const;
+        uint16_t overflows () const     { return this->_overflows; }                 //!<number of packets refused
+        uint8_t  pending () const       { return (uint8_t) (this->_head - this->_tail); }    //!<bytes not sent yet
+        int      pop ();
+        bool     push (const uint8_t *buffer, uint8_t len);
+        uint8_t  space () const         { return FRSKY_D_TX_QUEUE - this->pending (); }      //!<free bytes
+        void     tick ();
+
+        static bool timer2 ();
+        static void timer2Tick ();
+
+    private:
+        void     _start ();
+
+        uint8_t           _buf[FRSKY_D_TX_QUEUE];                   //!<ring buffer
+        volatile uint8_t  _head = 0;                                //!<bytes pushed (wraps) - written by push()
+        volatile uint8_t  _tail = 0;                                //!<bytes popped (wraps) - written by pop()
+        uint8_t           _highWater = 0;                           //!<see highWater()
+        uint16_t          _overflows = 0;                           //!<see overflows()
+#ifdef FRSKY_D_TX_TIMER2
+        volatile uint8_t *_port = NULL;                             //!<output register of the TX pin (NULL = none)
+        uint8_t           _mask;                                    //!<bit of the TX pin
+        uint8_t           _ocr;                                     //!<Timer2 compare value (one bit time)
+        uint8_t           _bit = 0;                                 //!<0: idle, 1~9: start and data bits sent, 10: stop bit sent
+        uint8_t           _byte;                                    //!<bits of the byte being sent, not sent yet
+#endif
+};
+
+#endif
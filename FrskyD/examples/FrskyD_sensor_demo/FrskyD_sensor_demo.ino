@@ -3,78 +3,73 @@
  * ------------
  * - FrskyD library - https://github.com/jcheger/frsky-arduino
  *
+ * The values are grouped in the 3 frames of the hub, and set in setup () (only the altitude changes). update () queues
+ * each frame when its period is over, and the queue is sent in the background: loop () never waits.
+ *
+ * No float is used: the values are given as integers (mV, hundredths).
+ *
  * 
  * origin: https://github.com/jcheger/frsky-arduino
  * author: Jean-Christophe Heger <jcheger@ordinoscope.net>
  */
 
 #include <FrskyD.h>
+#include <FrskyDTimer2.h>                               // async () sends with the Timer2 interrupt (no tone () then)
 #include <SoftwareSerial.h>
 
 FrskyD FrskyD (10, 11);
 
-void setup() {
-  FrskyD.ledSet (13);
-}
-
-void loop () {
-  static int i = 0;
-  static float alt = 10.0;
+FrskyDFrame<22> frame1 (FRSKY_D_FRAME1_PERIOD);   // accelerometers, altitude, temperature, voltage, current, rpm
+FrskyDFrame<11> frame2 (FRSKY_D_FRAME2_PERIOD);   // GPS, fuel
+FrskyDFrame<4>  frame3 (FRSKY_D_FRAME3_PERIOD);   // GPS date and time
 
-  FrskyD.sendData (FRSKY_D_ACCX,  1.1 * 1000.0);
-  FrskyD.sendData (FRSKY_D_ACCY, -1.2 * 1000.0);
-  FrskyD.sendData (FRSKY_D_ACCZ,  1.3 * 1000.0);
-  
-  FrskyD.sendFloat (FRSKY_D_ALT_B, FRSKY_D_ALT_A, alt);
+int32_t alt = 1000;  // [cm]
 
-  delay (200);  // wait a bit to flush buffer
-
-  FrskyD.sendCellVolt (0, 3.01);
-  FrskyD.sendCellVolt (1, 3.02);
-  FrskyD.sendCellVolt (2, 3.03);
-  FrskyD.sendCellVolt (3, 3.04);
-  FrskyD.sendCellVolt (4, 3.05);
-  FrskyD.sendCellVolt (5, 3.06);
-  FrskyD.sendCellVolt (6, 3.07);
-  FrskyD.sendCellVolt (7, 3.08);
-  FrskyD.sendCellVolt (8, 3.09);
-  FrskyD.sendCellVolt (9, 3.10);
-  FrskyD.sendCellVolt (10, 3.11);
-  FrskyD.sendCellVolt (11, 3.12);
+void setup() {
+  int i;
 
-  delay (200);  // wait a bit to flush buffer
+  FrskyD.async ();                                // send in the background - loop () never waits for the line
+  FrskyD.attach (&frame1);
+  FrskyD.attach (&frame2);
+  FrskyD.attach (&frame3);
 
-  FrskyD.sendData (FRSKY_D_FUEL, 23);
+  frame1.set (FRSKY_D_ACCX,  1.1 * 1000.0);
+  frame1.set (FRSKY_D_ACCY, -1.2 * 1000.0);
+  frame1.set (FRSKY_D_ACCZ,  1.3 * 1000.0);
+  frame1.setFixed (FRSKY_D_ALT_B, FRSKY_D_ALT_A, alt);
+  for (i = 0; i < 12; i++) frame1.setCellMv (i, 3010 + i * 10);
+  frame1.set (FRSKY_D_TEMP1, 28);
+  frame1.set (FRSKY_D_TEMP2, -18);
+  frame1.set (FRSKY_D_RPM, 11111 / 60);
+  frame1.set (FRSKY_D_CURRENT, 23.4 * 10);
+  frame1.set (FRSKY_D_VFAS, 12.3 * 10);
 
-  FrskyD.sendFloat (FRSKY_D_GPS_ALT_B, FRSKY_D_GPS_ALT_A, alt);
-  
-  FrskyD.sendFloat (FRSKY_D_GPS_COURSE_B, FRSKY_D_GPS_COURSE_A, 12.34);
-  
-  FrskyD.sendData  (FRSKY_D_GPS_DM, 10 << 8 | 12);
-  FrskyD.sendData  (FRSKY_D_GPS_HM, 14 << 8 | 25);
-  
+  frame2.set (FRSKY_D_FUEL, 23);
+  frame2.setFixed (FRSKY_D_GPS_ALT_B, FRSKY_D_GPS_ALT_A, alt);
+  frame2.setFixed (FRSKY_D_GPS_COURSE_B, FRSKY_D_GPS_COURSE_A, 1234);
   // 46° 56' 52.52''
-  FrskyD.sendData (FRSKY_D_GPS_LAT_B, 46 * 100 + 42);
-  FrskyD.sendData (FRSKY_D_GPS_LAT_A, 52.52 * 10000 / 60);
-  
+  frame2.set (FRSKY_D_GPS_LAT_B, 46 * 100 + 42);
+  frame2.set (FRSKY_D_GPS_LAT_A, 52.52 * 10000 / 60);
   // 7° 26' 40.59''
-  FrskyD.sendData (FRSKY_D_GPS_LONG_B, 7 * 100 + 26);
-  FrskyD.sendData (FRSKY_D_GPS_LONG_A, 40.59 * 10000 / 60);
-
-  FrskyD.sendData  (FRSKY_D_GPS_SEC, 36);
-  FrskyD.sendFloat (FRSKY_D_GPS_SPEED_B, FRSKY_D_GPS_SPEED_A, 100 / 1.852);  // OK, BUG
-  FrskyD.sendData  (FRSKY_D_GPS_YEAR, 14);
+  frame2.set (FRSKY_D_GPS_LONG_B, 7 * 100 + 26);
+  frame2.set (FRSKY_D_GPS_LONG_A, 40.59 * 10000 / 60);
+  frame2.setFixed (FRSKY_D_GPS_SPEED_B, FRSKY_D_GPS_SPEED_A, 100 * 100000L / 1852);  // 100 km/h, in knots * 100
 
-  delay (200);  // wait a bit to flush buffer
+  frame3.set (FRSKY_D_GPS_DM, 10 << 8 | 12);
+  frame3.set (FRSKY_D_GPS_YEAR, 14);
+  frame3.set (FRSKY_D_GPS_HM, 14 << 8 | 25);
+  frame3.set (FRSKY_D_GPS_SEC, 36);
+}
 
-  FrskyD.sendData  (FRSKY_D_TEMP1, 28);
-  FrskyD.sendData  (FRSKY_D_TEMP2, -18);
-  FrskyD.sendData  (FRSKY_D_RPM, 11111 / 60);
+void loop () {
+  static unsigned long alt_millis = 0;
 
-  FrskyD.sendData  (FRSKY_D_CURRENT, 23.4 * 10);
-  FrskyD.sendData  (FRSKY_D_VFAS, 12.3 * 10);
+  if (millis () - alt_millis >= FRSKY_D_FRAME1_PERIOD) {
+    alt_millis = millis ();
+    alt += 10;
+    frame1.setFixed (FRSKY_D_ALT_B, FRSKY_D_ALT_A, alt);
+    frame2.setFixed (FRSKY_D_GPS_ALT_B, FRSKY_D_GPS_ALT_A, alt);
+  }
 
-  alt += .1;
-  
-  delay (200);  // wait a bit to flush buffer
+  FrskyD.update ();
 }
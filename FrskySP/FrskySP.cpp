@@ -21,18 +21,39 @@
  * byte | description
  * -----|------------
  * 0x7E | poll header
- * ID   | physical ID (1-28) computed with a CRC (see \ref FrskySP_sensor_demo/FrskySP_sensor_demo.ino for the full list of polled IDs)
+ * ID   | physical ID (1-28) computed with a CRC (see FrskySPCrc::physicalId())
  * 
  * * The receiver will poll the IDs in sequence to find which one is present.
  * * If only one physical ID is found, the receiver will alternate the sensor polling and the search (present sensor,
  *   next ID to search, present sensor, next ID and so on).
  * * If more sensors are found, the poll sequence returns almost to a normal search pattern.
  * 
+ * FrskySP::update() parses the polls without waiting for the receiver, and calls the handler registered for the
+ * polled physical ID with FrskySP::onPoll(), or sends the packet pre-encoded in the FrskySPSlot attached with
+ * FrskySP::attach().
+ * 
+ * FrskySPDecoder follows the whole bus instead (polls and answers, unstuffed and checked), as a sniffer or a gateway
+ * does. tools/host/decode runs it on Linux, on a tty or a capture file.
+ * 
+ * tools/host/x8r simulates the receiver side in virtual time: it polls FrskySP sensors as an X8R does, and reports
+ * their answers per physical ID (latency, missed, late, collisions).
+ * 
+ * On the sensor side, FrskySP::measure() keeps a latency histogram per physical ID (see FrskySPTiming), when the
+ * library is built with FRSKY_SP_TIMING at 1. FrskySP::stats() and FrskySPDecoder::stats() count the bus health
+ * events (see FrskySPStats): bad CRCs, overflows, underflows, polls per physical ID, answers.
+ * 
+ * FrskySPPins<RX, TX> replaces FrskySP (RX, TX) without heap allocation: the RAM taken is known at link time.
+ * tools/host/footprint ("make size") reports the RAM and code size of each feature.
+ * 
+ * Several buses (FrskySP, FrskyD) can be served from one board: FrskySPPump calls their step() in turn, and tells the
+ * longest time each bus may wait (see the FrskySP_multi_bus example).
+ * 
  * Sensor behavior
  * ---------------
  * Genuine Frsky sensors: the sensor answers to every pool on its physical ID to announce its presence. If no data can
  * be transmitted (no refresh), the sensor answers by an empty packet and a false CRC (type 0x00, ID 0x0000,
- * value 0x00000000, CRC 0xFF).
+ * value 0x00000000, CRC 0xFF). FrskySP does the same for the physical IDs given to FrskySP::keepAlive(), at once or
+ * after a deadline (see FrskySP::deadline()).
  * 
  * byte(s) | descrption
  * --------|-----------
@@ -46,6 +67,8 @@
  * There are 2 recurrent discussions on Internet, that are related to what is used in this code and examples:
  * * SoftwareSerial is too slow - no, it is not (at least in Arduino 1.0+). The answers from the Arduino are even faster
  *   than the genuine Frksy sensors. Allthough, the annoying point is the conflict with the PinChangeInt library.
+ *   SoftwareSerial is only the default: a hardware UART, AltSoftSerial or a Linux tty can be used instead, each one
+ *   reporting its turnaround (see FrskySPTransport).
  * * Floating point computing is slow - yes and no. The slowness is reversed if the input or the output of the formula
  *   is a float. Example:
  * ~~~~~
@@ -59,12 +82,21 @@
  * poll cycle (11 ms). Allthough, OpenTX has many computing to do and has no time to lose. There is a little drift for
  * the GPS and airspeed values shown on the remote control.
  * 
+ * No float is needed at all: the sensors give integers (mV, mA, cm, mph...), and FrskySPScale converts them to the
+ * value formats with a compile-time scale (ex. FrskySPScale<1, 10>::encode (mv) for \ref FRSKY_SP_VFAS), and
+ * FrskySP::lipoCellMv() encodes the cells from millivolts.
+ * 
+ * The scale, unit and usual physical ID of each logical ID are in FrskySPSensors::table: FrskySPCodec encodes and
+ * decodes an ID with them (ex. FrskySPCodec<FRSKY_SP_VFAS>::encode<1000> (mv)), and FrskySPSensors::lookup() gives
+ * them for any received ID.
+ * 
  * Although, you must be careful around those issues:
  * * only one sensor per physical ID (ex. GPS and normal precision altimeter share the same physical ID 3)
  * * only one answer per poll cycle (the [FrskySP_sensor_demo.ino](\ref FrskySP_sensor_demo/FrskySP_sensor_demo.ino)
  *   example shows how to handle multiple answers for one physical ID)
  * * take care about the polling time of the sensor. For instance, polling a DS18x20 temperature sensor takes up to
- *   750ms. The polling must be asynchronous to be answered within the cycle of 11ms.
+ *   750ms. The polling must be asynchronous to be answered within the cycle of 11ms: split it in short steps, and let
+ *   FrskySPScheduler run them between the polls.
  * 
  * Connection draft
  * ================
@@ -83,13 +115,11 @@
  * \see http://www.open-tx.org/
  * \copyright 2014 - Jean-Christophe Heger - Released under the LGPL 3.0 license.
  * \ChangeLog 2014-06-27 - public devel release
- * \todo write an example to simulate an X8R receiver
  * 
- * \bug There is an unsolved bug with one value only, until now. While trying to send airspeed value 100 mph, converted
- * to knots, the receiver will not detect the sensor and not send the value to the remote neither. It works perfectly
- * with 101 or 99 mph, but 100 mph will hang.
+ * A 0x7E or 0x7D byte in a packet is stuffed (see FrskySPStuffing): airspeed 100 mph, converted to knots, used to hang
+ * the receiver, its CRC being 0x7E.
  * ~~~
- * FrskySP.sendData (FRSKY_SP_AIR_SPEED, 100 * 10 / 1.15077945);    // packet: 0x10 00 0A 64 03 00 00 7E
+ * FrskySP.sendData (FRSKY_SP_AIR_SPEED, 100 * 10 / 1.15077945);    // sent: 0x10 00 0A 64 03 00 00 7D 5E
  * ~~~
  */
  
@@ -116,39 +146,176 @@ union FrskySP::packet {
 };
 
 /**
- * Open a SoftwareSerial connection
+ * Open a SoftwareSerial connection (see FrskySPSoftSerial). The transport is allocated on the heap: FrskySPPins keeps
+ * it in the object instead.
  * \param pinRx RX pin
  * \param pinTx TX pin
  * \brief Class constructor
  * \warning after opening the ports with SoftwareSerial, and because of the mux between TX and RX, RX will hang.
- *   The workaround is to revert the TX port as INPUT, and put it back again as OUTPUT at the first available()
- *   call.
- * \todo allow the use [AltSoftSerial] (http://www.pjrc.com/teensy/td_libs_AltSoftSerial.html) instead - much faster
- *   than SerialSoftware, and no conflict with [PinChangeInt] (https://code.google.com/p/arduino-pinchangeint/) - see
- *  [bugs] (https://code.google.com/p/arduino-pinchangeint/wiki/Bugs).
+ *   The workaround is to revert the TX port as INPUT, and put it back again as OUTPUT when the first byte is
+ *   received (done by FrskySPSoftSerial).
  */
 FrskySP::FrskySP (int pinRx, int pinTx) {
-    this->_pinRx = pinRx;
-    this->_pinTx = pinTx;
-    this->mySerial = new SoftwareSerial (pinRx, pinTx, true);
-    this->mySerial->begin (57600);
-    pinMode (pinTx, INPUT); // RX freeze workaround
+    FrskySPSoftSerial *soft = new FrskySPSoftSerial (pinRx, pinTx);
+
+    this->transport = soft;
+    this->mySerial  = &soft->serial;
+    this->transport->begin (FRSKY_SP_SPEED);
 }
 
 /**
- * Check if a byte is available on Smart Port
+ * Use a hardware UART, AltSoftSerial or a Linux tty instead of SoftwareSerial (see FrskySPTransport). The transport
+ * is not opened here - a global FrskySP may be constructed before the serial port: call its begin() from setup().
+ * ~~~~~
+ * FrskySPSerial<HardwareSerial> bus (Serial1, 2);
+ * FrskySP FrskySP (bus);
+ *
+ * void setup () {
+ *   bus.begin (FRSKY_SP_SPEED);
+ * }
+ * ~~~~~
+ * \brief Class constructor, on a transport
+ * \param transport transport
+ */
+FrskySP::FrskySP (FrskySPTransport &transport) {
+    this->transport = &transport;
+    this->mySerial  = NULL;
+}
+
+/**
+ * The slot is sent as is on polls of this physical ID, by feed() (and so by update()), if no handler is registered
+ * for this ID with onPoll(). Nothing is sent as long as the slot has no value.
+ * 
+ * Several slots can be attached to the same physical ID: each poll sends the most overdue one (see \ref FrskySPSlot).
  * 
- * Reverts the TX pin to OUTPUT mode after the first available byte
- * \brief SoftwareSerial.available() passthrough
+ * \brief Answer the polls of a physical ID with pre-encoded packets
+ * \param id physical ID (0~27)
+ * \param slot slot to add (NULL to remove all the slots of this ID)
+ */
+void FrskySP::attach (uint8_t id, FrskySPSlot *slot) {
+    FrskySPSlot **p;
+
+    if (id >= FRSKY_SP_PHYSICAL_IDS) return;
+    if (!slot) {
+        this->_slots[id] = NULL;
+        return;
+    }
+    for (p = &this->_slots[id]; *p; p = &(*p)->_next) {
+        if (*p == slot) return;             // already attached
+    }
+    slot->_next = NULL;
+    *p = slot;
+}
+
+/**
+ * Check if a byte is available on Smart Port
+ * \brief FrskySPTransport::available() passthrough
  */
 int FrskySP::available () {
-    static bool mode = 1;                   // at first call, mode is INPUT
-    int r = this->mySerial->available ();
-    if (mode && r) {                        // RX freeze workaround
-        pinMode (this->_pinTx, OUTPUT);     
-        mode = 0;                           // mode is OUPUT from now
+    return this->transport->available ();
+}
+
+/**
+ * With keepAlive(), a poll that finds no fresh value is not answered with the empty packet at once: a value set in a
+ * slot of the polled physical ID (see FrskySPSlot::set(), ex. from an interrupt or the end of a sensor read) is still
+ * sent if it comes within the deadline, and the empty packet when the deadline is over. update() or step() must then be
+ * called often enough to see both.
+ *
+ * Keep it well within the answer window of the receiver (see FrskySPTiming), turnaround of the transport included.
+ * It does not apply to the IDs answered by a handler (onPoll()): a handler decides at once.
+ * \brief Wait for a fresh value before sending the empty packet
+ * \param us deadline after the poll [µs] (0: decide at once - the default)
+ */
+void FrskySP::deadline (uint16_t us) {
+    this->_deadline = us;
+}
+
+/**
+ * Byte-fed poll parser: give it every byte received on the bus. When a poll header is followed by a valid physical
+ * ID, the handler registered for this ID with onPoll() is called, or the slot attached with attach() is sent (at
+ * once - there is no search). Anything else (the answers of the other sensors) is ignored.
+ *
+ * A poll is only answered if its physical ID is the last byte received: when bytes are still waiting in the transport
+ * (loop() was late, and the next poll or another answer is already there), the poll is counted in
+ * FrskySPStats::polls and FrskySPStats::underflows, and left unanswered.
+ * 
+ * \brief Feed the poll parser with one received byte
+ * \param b received byte
+ * \return physical ID (0~27) if b completes a poll, -1 otherwise
+ */
+int FrskySP::feed (byte b) {
+    uint8_t id = b & 0x1f;
+    FrskySPSlot *slot;
+
+    if (b == FRSKY_SP_POLL) {
+        if (this->_waiting >= 0) {          // the next poll starts: too late to answer
+            this->_waiting = -1;
+            FrskySPStats::count (this->_stats.underflows);
+#if FRSKY_SP_TIMING
+            this->_answering = -1;
+#endif
+        }
+        this->_polled = true;
+        return -1;
+    }
+    if (!this->_polled) return -1;
+    this->_polled = false;
+
+    if (id >= FRSKY_SP_PHYSICAL_IDS || FrskySPCrc::physicalId (id) != b) {
+        FrskySPStats::count (this->_stats.dropped);
+        return -1;
     }
-    return r;
+    FrskySPStats::count (this->_stats.polls[id]);
+    if (!this->_handlers[id] && !this->_slots[id] && !(this->_keepAlive & 1UL << id)) return id;   // not answered by this sensor
+    if (this->available ()) {               // more bytes came after the poll: its slot is over, an answer would collide
+        FrskySPStats::count (this->_stats.underflows);
+        return id;
+    }
+    this->_replied = false;
+#if FRSKY_SP_TIMING
+    this->_pollTime  = this->_rxTime ? this->_rxTime : micros ();
+    this->_answering = id;
+#endif
+    if (this->_handlers[id]) {
+        this->_handlers[id] (id);
+    } else if (this->_slots[id]) {
+        slot = FrskySPSlot::pick (this->_slots[id], millis ());
+        if (slot) this->send (*slot);
+    }
+    if (!this->_replied && this->_keepAlive & 1UL << id) {
+        if (this->_deadline && !this->_handlers[id]) {
+            this->_waiting   = id;          // see _wait()
+            this->_waitStart = micros ();
+            return id;
+        }
+        this->sendEmpty ();
+    }
+    if (!this->_replied) FrskySPStats::count (this->_stats.underflows);
+#if FRSKY_SP_TIMING
+    this->_answering = -1;
+#endif
+    return id;
+}
+
+/**
+ * Genuine sensors answer every poll of their physical ID, with the empty packet (type 0, ID 0, value 0, CRC 0xFF) when
+ * they have nothing new: the receiver then keeps polling the ID in its fast, alternating pattern (see \ref index). A
+ * sensor that stays silent is searched for again, and polled less often.
+ *
+ * With keep-alive, a poll of this ID that is not answered (no handler, no slot, nothing changed in the slots, or a
+ * handler that did not send) gets the empty packet - at once, or at the deadline (see deadline()).
+ * ~~~~~
+ * FrskySP.attach (4, &rpm);
+ * FrskySP.keepAlive (4);
+ * ~~~~~
+ * \brief Answer every poll of a physical ID
+ * \param id physical ID (0~27)
+ * \param on true to answer every poll, false to answer only with a value (the default)
+ */
+void FrskySP::keepAlive (uint8_t id, bool on) {
+    if (id >= FRSKY_SP_PHYSICAL_IDS) return;
+    if (on) this->_keepAlive |= 1UL << id;
+    else    this->_keepAlive &= ~(1UL << id);
 }
 
 /**
@@ -169,38 +336,55 @@ void FrskySP::_ledToggle (int state) {
 }
 
 /**
+ * \brief Timestamp the first byte of an answer (FRSKY_SP_TIMING)
+ */
+void FrskySP::_timingStart () {
+#if FRSKY_SP_TIMING
+    this->_txStart = micros ();
+#endif
+}
+
+/**
+ * The answer is counted in the histogram of the polled physical ID, if any (see measure()). The bytes read next by
+ * update() are taken as received after now (SoftwareSerial does not receive while sending).
+ * \brief Timestamp the end of an answer (FRSKY_SP_TIMING)
+ */
+void FrskySP::_timingEnd () {
+#if FRSKY_SP_TIMING
+    unsigned long now = micros ();
+
+    if (this->_answering >= 0 && this->_timings[this->_answering]) {
+        this->_timings[this->_answering]->_add (this->_txStart - this->_pollTime, now - this->_txStart);
+    }
+    this->_answering = -1;                  // one answer per poll
+    if (this->_rxTime) this->_rxTime = now;
+#endif
+}
+
+/**
+ * Only the 7 first bytes are used (type, logical ID and value), the 8th byte is ignored.
  * \brief Calculate the CRC of a packet
- * \see https://github.com/opentx/opentx/blob/next/radio/src/telemetry/frsky_sport.cpp
+ * \see FrskySPCrc
  * \param packet packet pointer (in byte[8] presentation)
  */
 uint8_t FrskySP::CRC (uint8_t *packet) {
-    short crc = 0;
-    for (int i=0; i<8; i++) {
-        crc += packet[i]; //0-1FF
-        crc += crc >> 8;  //0-100
-        crc &= 0x00ff;
-        crc += crc >> 8;  //0-0FF
-        crc &= 0x00ff;
-    }
-    return ~crc;
+    FrskySPCrc crc;
+    crc.update (packet, 7);
+    return crc.crc ();
 }
 
 /**
  * \brief Check the CRC of a packet
- * \see https://github.com/opentx/opentx/blob/next/radio/src/telemetry/frsky_sport.cpp
- * \param packet packet pointer
- * \return true if CRC if false
+ * \see FrskySPCrc
+ * \param packet packet pointer (type, logical ID, value and CRC, as sent by sendData())
+ * \return true if CRC is valid
  */
 bool FrskySP::CRCcheck (uint8_t *packet) {
-    short crc = 0;
-    for (int i=1; i<8; i++) {
-        crc += packet[i]; //0-1FF
-        crc += crc >> 8;  //0-100
-        crc &= 0x00ff;
-        crc += crc >> 8;  //0-0FF
-        crc &= 0x00ff;
-    }
-    return (crc == 0x00ff);
+    FrskySPCrc crc;
+    crc.update (packet, 8);
+    if (crc.valid ()) return true;
+    FrskySPStats::count (this->_stats.crcErrors);
+    return false;
 }
 
 /**
@@ -241,10 +425,109 @@ uint32_t FrskySP::lipoCell (uint8_t id, float val1, float val2) {
 }
 
 /**
- * \brief SoftwareSerial.read() passthrough
+ * \brief Same as lipoCellMv(uint8_t id, uint16_t mv1, uint16_t mv2), but with only one cell.
+ * \param id cell ID (0~11)
+ * \param mv cell voltage [mV]
+ * \return formated data for cell voltage (1 cell)
+ */
+uint32_t FrskySP::lipoCellMv (uint8_t id, uint16_t mv) {
+    if (this->_cellMax < id + 1) this->_cellMax = id + 1;
+    return (uint32_t) FrskySPScale<1, 2>::encode (mv) << 8 | this->_cellMax << 4 | id;
+}
+
+/**
+ * Same data format as lipoCell(uint8_t id, float val1, float val2), without any float: V * 500 is mV / 2.
+ * \brief Lipo voltage data format for 2 cells, from millivolts
+ * \param id cell ID (0~11)
+ * \param mv1 cell voltage [mV] (for cell ID)
+ * \param mv2 cell voltage [mV] (for cell ID+1)
+ * \return formated data for cell voltage (2 cells)
+ */
+uint32_t FrskySP::lipoCellMv (uint8_t id, uint16_t mv1, uint16_t mv2) {
+    if (this->_cellMax < id + 2) this->_cellMax = id + 2;
+    return ((uint32_t) FrskySPScale<1, 2>::encode (mv2) & 0x0fff) << 20
+         | ((uint32_t) FrskySPScale<1, 2>::encode (mv1) & 0x0fff) << 8 | this->_cellMax << 4 | id;
+}
+
+/**
+ * Each answer to a poll of this physical ID (by feed() or update(), with a slot or a handler) adds its latency to the
+ * histogram: from the reception of the physical ID to the first byte sent. With update(), the reception time is the
+ * end of the previous update() call - the last time the byte was surely not there yet - so that the time spent in
+ * loop() is counted: it is the worst case. With feed() alone, it is the time of the feed() call.
+ * 
+ * Does nothing if the library is built with FRSKY_SP_TIMING at 0 (default).
+ * 
+ * \brief Measure the poll to answer latency of a physical ID
+ * \see FrskySPTiming
+ * \param id physical ID (0~27)
+ * \param timing histogram (NULL to stop measuring)
+ */
+void FrskySP::measure (uint8_t id, FrskySPTiming *timing) {
+#if FRSKY_SP_TIMING
+    if (id < FRSKY_SP_PHYSICAL_IDS) this->_timings[id] = timing;
+#else
+    (void) id;
+    (void) timing;
+#endif
+}
+
+/**
+ * The handler is called by feed() (and so by update()) each time the receiver polls this physical ID. It must answer
+ * quickly, with one sendData() at most.
+ * ~~~~~
+ * void sendRpm (uint8_t id) {
+ *   FrskySP.sendData (FRSKY_SP_RPM, rpm);
+ * }
+ * 
+ * FrskySP.onPoll (4, sendRpm);    // poll byte 0xE4
+ * ~~~~~
+ * 
+ * \brief Register a poll handler
+ * \param id physical ID (0~27)
+ * \param handler handler (NULL to remove it)
+ */
+void FrskySP::onPoll (uint8_t id, FrskySPHandler handler) {
+    if (id < FRSKY_SP_PHYSICAL_IDS) this->_handlers[id] = handler;
+}
+
+/**
+ * \brief FrskySPTransport::read() passthrough
  */
 byte FrskySP::read () {
-    return this->mySerial->read ();
+    return this->transport->read ();
+}
+
+/**
+ * The packet was encoded by FrskySPSlot::set(): there is nothing left to compute, the 8 bytes are copied, stuffed as
+ * set() found (see FrskySPStuffing), and sent in one burst.
+ * \brief Send a pre-encoded packet
+ * \param slot slot
+ */
+void FrskySP::send (FrskySPSlot &slot) {
+    uint8_t packet[FRSKY_SP_PACKET_MAX];
+    uint8_t mask, seq;
+
+    seq = slot.copy (packet, &mask);
+    this->_write (packet, FrskySPStuffing::stuff (packet, mask));
+    slot._sent (seq, millis ());
+}
+
+/**
+ * The packet is constant (nothing to compute or stuff). See keepAlive().
+ * \brief Send the empty packet (type 0, ID 0, value 0, CRC 0xFF)
+ */
+void FrskySP::sendEmpty () {
+    static const uint8_t empty[8] = {0, 0, 0, 0, 0, 0, 0, FrskySPCrc::packet (0, 0, 0)};
+
+    this->_write (empty, 8);
+    FrskySPStats::count (this->_stats.empty);
+}
+
+/**
+ * \brief Clear the bus health counters (see FrskySPStats)
+ */
+void FrskySP::statsReset () {
+    this->_stats = FrskySPStats ();
 }
 
 /**
@@ -267,7 +550,9 @@ void FrskySP::sendData (uint16_t id, int32_t val) {
  * type      | 8 bit  | always 0x10 at now
  * sensor ID | 16 bit | sensor's logical ID (see FrskySP.h for values)
  * data      | 32 bit | preformated data
- * crc       | 8 bit  | calculated by CRC()
+ * crc       | 8 bit  | end-around carry sum of the other bytes (see FrskySPCrc)
+ *
+ * The packet is stuffed (see FrskySPStuffing) before the line is taken, then sent in one burst.
  * 
  * \brief Prepare the packet and send it.
  * \param type value type
@@ -276,20 +561,113 @@ void FrskySP::sendData (uint16_t id, int32_t val) {
  * \return return the CRC for control
  */
 void FrskySP::sendData (uint8_t type, uint16_t id, int32_t val) {
-    int i = 0;
-    union packet packet;
+    uint8_t packet[FRSKY_SP_PACKET_MAX];
+    FrskySPCrc crc;
+
+    packet[0] = type;
+    packet[1] = id;
+    packet[2] = id >> 8;
+    packet[3] = val;
+    packet[4] = val >> 8;
+    packet[5] = val >> 16;
+    packet[6] = val >> 24;
+    crc.update (packet, 7);
+    packet[7] = crc.crc ();
+    this->_write (packet, FrskySPStuffing::stuff (packet, FrskySPStuffing::mask (packet)));
+}
 
-    packet.uint64  = (uint64_t) type | (uint64_t) id << 8 | (int64_t) val << 24;
-    packet.byte[7] = this->CRC (packet.byte);
+/**
+ * One byte at most: the poll it completes is answered at once (handler or slot). Several buses can then be served in
+ * turn without one delaying the others by more than one byte, or one answer (see FrskySPPump).
+ * \brief Handle one received byte
+ * \return true if a byte was handled, false if none was received
+ */
+bool FrskySP::step () {
+    if (!this->available ()) {
+        if (this->transport->overflow ()) FrskySPStats::count (this->_stats.overflows);
+        if (this->transport->echoLost ()) FrskySPStats::count (this->_stats.echoes);
+#if FRSKY_SP_TIMING
+        this->_idle = micros ();
+#endif
+        return this->_wait ();
+    }
+#if FRSKY_SP_TIMING
+    this->_rxTime = this->_idle;
+#endif
+    this->feed (this->read ());
+#if FRSKY_SP_TIMING
+    this->_rxTime = 0;
+#endif
+    return true;
+}
 
-	this->_ledToggle (HIGH);
-    for (i=0; i<8; i++) this->mySerial->write (packet.byte[i]);
-	this->_ledToggle (LOW);
+/**
+ * Reads only what is already received, and never waits for the next byte: if the physical ID of a poll is not there
+ * yet, it will be handled by the next call. Call it as often as possible from loop().
+ * 
+ * \brief Handle the received bytes
+ * \return last physical ID polled (0~27), -1 if none
+ */
+int FrskySP::update () {
+    int id = -1;
+    int r;
+
+#if FRSKY_SP_TIMING
+    this->_rxTime = this->_idle;
+#endif
+    while (this->available ()) {
+        r = this->feed (this->read ());
+        if (r >= 0) id = r;
+    }
+    if (this->transport->overflow ()) FrskySPStats::count (this->_stats.overflows);
+    if (this->transport->echoLost ()) FrskySPStats::count (this->_stats.echoes);
+#if FRSKY_SP_TIMING
+    this->_rxTime = 0;
+    this->_idle   = micros ();
+#endif
+    this->_wait ();
+    return id;
 }
 
 /**
- * \brief SoftwareSerial.write() passthrough
+ * \brief FrskySPTransport::write() passthrough
  */
 byte FrskySP::write (byte val) {
-    return this->mySerial->write (val);
+    return this->transport->write (val);
+}
+
+/**
+ * \brief Answer the poll waiting for a fresh value, if it came or if the deadline is over (see deadline())
+ * \return true if an answer was sent
+ */
+bool FrskySP::_wait () {
+    FrskySPSlot *slot;
+    uint8_t id = this->_waiting;
+
+    if (this->_waiting < 0) return false;
+    slot = FrskySPSlot::pick (this->_slots[id], millis ());
+    if (slot)                                                   this->send (*slot);
+    else if (micros () - this->_waitStart >= this->_deadline)   this->sendEmpty ();
+    else                                                        return false;
+    this->_waiting = -1;
+    return true;
+}
+
+/**
+ * \brief Send an answer, in one burst
+ * \param buf bytes on the wire (stuffed)
+ * \param len number of bytes
+ */
+void FrskySP::_write (const uint8_t *buf, uint8_t len) {
+    uint8_t i;
+
+	this->_ledToggle (HIGH);
+    this->transport->txBegin ();
+    this->_timingStart ();
+    for (i=0; i<len; i++) this->transport->write (buf[i]);
+    this->transport->txEnd ();
+    this->_timingEnd ();
+	this->_ledToggle (LOW);
+    this->_replied = true;
+    FrskySPStats::count (this->_stats.replies);
 }
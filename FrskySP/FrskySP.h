@@ -1,9 +1,49 @@
 /**
  * \file FrskySP.h
  */
- 
+
+#ifndef FrskySP_h
+#define FrskySP_h
+
 #include "Arduino.h"
 #include "SoftwareSerial.h"
+#include "FrskySPCrc.h"
+#include "FrskySPDecoder.h"
+#include "FrskySPFreq.h"
+#include "FrskySPPump.h"
+#include "FrskySPRpm.h"
+#include "FrskySPScale.h"
+#include "FrskySPScheduler.h"
+#include "FrskySPSlot.h"
+#include "FrskySPStats.h"
+#include "FrskySPStuffing.h"
+#include "FrskySPTiming.h"
+#include "FrskySPTransport.h"
+
+/**
+ * \brief Poll header sent by the receiver, followed by the physical ID (see FrskySPCrc::physicalId())
+ */
+#define FRSKY_SP_POLL           0x7E
+
+/**
+ * A 0x7E or 0x7D byte in a packet is sent as 0x7D, then the byte xor 0x20
+ * \brief Byte stuffing marker
+ */
+#define FRSKY_SP_STUFF          0x7D
+
+/**
+ * \brief Smart Port speed [bds]
+ */
+#define FRSKY_SP_SPEED          57600
+
+/**
+ * Set to 1 to measure the poll to answer latency (see FrskySP::measure()): edit it here, or build with
+ * -DFRSKY_SP_TIMING=1. At 0, the instrumentation is not compiled at all.
+ * \brief Latency instrumentation switch
+ */
+#ifndef FRSKY_SP_TIMING
+#define FRSKY_SP_TIMING         0
+#endif
 
 /**
  * unused
@@ -61,7 +101,7 @@
  * info | comment
  * ---- | -------
  * sensor ID(s)   | FRSKY_SP_CELLS ~ FRSKY_SP_CELLS+15 (0x0300 ~ 0x030f)
- * physical ID(s) | ?
+ * physical ID(s) | 1 - FLVSS Lipo sensor
  * value          | see FrskySP::lipoCell(uint8_t id, float val1, float val2) for data format
  * 
  * \brief FLVSS Lipo cell voltage
@@ -72,7 +112,7 @@
  * info | comment
  * ---- | -------
  * sensor ID(s)   | FRSKY_SP_T1 ~ FRSKY_SP_T1+15 (0x0400 ~ 0x040f)
- * physical ID(s) | 1 - FLVSS Lipo sensor
+ * physical ID(s) | ?
  * value          | int [°C]
  * 
  * \brief Temperature
@@ -307,6 +347,13 @@
  */
 #define FRSKY_SP_SWR_ID         0xf105
 
+#include "FrskySPSensors.h"                                 // table of the IDs above
+
+/**
+ * Poll handler, called with the physical ID (0~27) polled by the receiver
+ */
+typedef void (*FrskySPHandler) (uint8_t id);
+
 /**
  * Frsky Smart Port class
  */
@@ -315,31 +362,93 @@ class FrskySP {
     public:
         // methods
         FrskySP (int pinRx, int pinTx);
+        FrskySP (FrskySPTransport &transport);
+        void     attach (uint8_t id, FrskySPSlot *slot);
         int      available ();
         uint8_t  CRC (uint8_t *packet);
         bool     CRCcheck (uint8_t *packet);
+        void     deadline (uint16_t us);
+        int      feed (byte b);
+        void     keepAlive (uint8_t id, bool on = true);
 		void     ledSet (int pin);
         uint32_t lipoCell (uint8_t id, float val);
         uint32_t lipoCell (uint8_t id, float val1, float val2);
+        uint32_t lipoCellMv (uint8_t id, uint16_t mv);
+        uint32_t lipoCellMv (uint8_t id, uint16_t mv1, uint16_t mv2);
+        void     measure (uint8_t id, FrskySPTiming *timing);
+        void     onPoll (uint8_t id, FrskySPHandler handler);
         byte     read ();
+        FrskySPStats stats () const     { return this->_stats; }    //!<snapshot of the bus health counters
+        void     statsReset ();
+        bool     step ();
+        void     send (FrskySPSlot &slot);
         void     sendData (uint16_t id, int32_t val);
         void     sendData (uint8_t type, uint16_t id, int32_t val);
+        void     sendEmpty ();
+        int      update ();
         byte     write (byte val);
 
         // attributes
-        SoftwareSerial *mySerial;                                   //!<SoftwareSerial object
+        SoftwareSerial *mySerial;                                   //!<SoftwareSerial object (NULL with another transport)
+        FrskySPTransport *transport;                                //!<transport (see FrskySPTransport)
         union packet;                                               //!<Packet union (byte[8], uint64)
 
 		uint8_t _cellMax = 0;
 
     private:
 		void    _ledToggle (int state);
-		int     _pinLed = -1;										//!<LED pin (-1 = disabled)
-        int     _pinRx;												//!<RX pin used by SoftwareSerial
-        int     _pinTx;												//!<TX pin used by SoftwareSerial
+        void    _timingStart ();
+        void    _timingEnd ();
+        bool    _wait ();
+        void    _write (const uint8_t *buf, uint8_t len);
+		int8_t  _pinLed = -1;										//!<LED pin (-1 = disabled)
+        bool    _polled = false;                                    //!<poll header received, waiting for the physical ID
+        bool    _replied = false;                                   //!<an answer was sent since the last poll
+        int8_t  _waiting = -1;                                      //!<physical ID waiting for a fresh value (-1 = none, see deadline())
+        uint16_t _deadline = 0;                                     //!<see deadline() [µs]
+        uint32_t _keepAlive = 0;                                    //!<physical IDs answered on every poll (bit per ID, see keepAlive())
+        unsigned long _waitStart;                                   //!<micros() at the poll of _waiting
+        FrskySPStats _stats = {};                                   //!<see stats()
+        FrskySPHandler _handlers[FRSKY_SP_PHYSICAL_IDS] = {};       //!<poll handlers, indexed by physical ID
+        FrskySPSlot   *_slots[FRSKY_SP_PHYSICAL_IDS] = {};          //!<pre-encoded answers (lists), indexed by physical ID
+#if FRSKY_SP_TIMING
+        FrskySPTiming *_timings[FRSKY_SP_PHYSICAL_IDS] = {};        //!<latency histograms, indexed by physical ID
+        int8_t         _answering = -1;                             //!<physical ID being answered (-1 = none)
+        unsigned long  _idle = 0;                                   //!<micros() at the end of the last update()
+        unsigned long  _rxTime = 0;                                 //!<last update() end: the bytes read were not received yet (0 = unknown)
+        unsigned long  _pollTime;                                   //!<reception time of the physical ID being answered
+        unsigned long  _txStart;                                    //!<micros() at the first byte of the answer
+#endif
     
 };
 
+/**
+ * FrskySP on SoftwareSerial, with the pins given when compiling: the transport is a member, not allocated on the heap
+ * as FrskySP::FrskySP(int, int) does. A global object then takes a fixed amount of RAM, known at link time, and each
+ * bus has its own RX freeze workaround state (see FrskySPSoftSerial).
+ * ~~~~~
+ * FrskySPPins<10, 11> FrskySP;                                    // instead of: FrskySP FrskySP (10, 11);
+ * ~~~~~
+ * \brief FrskySP on SoftwareSerial, pins known when compiling
+ * \tparam RX RX pin
+ * \tparam TX TX pin
+ */
+template <uint8_t RX, uint8_t TX> class FrskySPPins : public FrskySP {
+    static_assert (RX != TX, "FrskySPPins: RX and TX must be different pins");
+
+    public:
+        /**
+         * \brief Class constructor (opens the line)
+         */
+        FrskySPPins () : FrskySP (_soft), _soft (RX, TX) {
+            this->mySerial = &this->_soft.serial;
+            this->_soft.begin (FRSKY_SP_SPEED);
+        }
+
+    private:
+        FrskySPSoftSerial _soft;                                    //!<transport (constructed after FrskySP, which only keeps its address)
+};
+
 /**
  * \example FrskySP_sensor_demo/FrskySP_sensor_demo.ino
  */
@@ -355,3 +464,9 @@ class FrskySP {
 /**
  * \example FrskySP_airspeed_sensor_eagletree/FrskySP_airspeed_sensor_eagletree.ino
  */
+
+/**
+ * \example FrskySP_multi_bus/FrskySP_multi_bus.ino
+ */
+
+#endif
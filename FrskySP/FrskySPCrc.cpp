@@ -0,0 +1,58 @@
+/**
+ * \file FrskySPCrc.cpp
+ */
+
+#include "FrskySPCrc.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * \brief Add several bytes to the sum
+ * \param buf bytes
+ * \param len number of bytes
+ */
+void FrskySPCrc::update (const uint8_t *buf, uint8_t len) {
+    uint16_t sum = this->_sum;
+    while (len--) sum += *buf++;
+    this->_sum = fold (sum);
+}
+
+/**
+ * The packets are 8 bytes each (type, logical ID, value, CRC), one after the other, as stored by a receiver or a
+ * capture tool. On hosts with SSE2, 2 packets are summed by one instruction (PSADBW). On other targets, each packet is
+ * summed in a 16 bits word and folded once.
+ *
+ * \brief Check the CRC of many packets at once
+ * \param packets packets (count * 8 bytes)
+ * \param count number of packets
+ * \param valid if not NULL, receives 1 (valid) or 0 (invalid) for each packet
+ * \return number of valid packets
+ */
+size_t FrskySPCrc::check (const uint8_t *packets, size_t count, uint8_t *valid) {
+    size_t i = 0;
+    size_t n = 0;
+    uint8_t ok;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+    for (; i + 2 <= count; i += 2) {
+        __m128i sums = _mm_sad_epu8 (_mm_loadu_si128 ((const __m128i *) (packets + i * 8)), zero);
+        ok = fold (_mm_extract_epi16 (sums, 0)) == 0xFF;
+        n += ok;
+        if (valid) valid[i] = ok;
+        ok = fold (_mm_extract_epi16 (sums, 4)) == 0xFF;
+        n += ok;
+        if (valid) valid[i + 1] = ok;
+    }
+#endif
+
+    for (; i < count; i++) {
+        const uint8_t *p = packets + i * 8;
+        ok = fold ((uint16_t) p[0] + p[1] + p[2] + p[3] + p[4] + p[5] + p[6] + p[7]) == 0xFF;
+        n += ok;
+        if (valid) valid[i] = ok;
+    }
+    return n;
+}
@@ -0,0 +1,93 @@
+/**
+ * \file FrskySPCrc.h
+ */
+
+#ifndef FrskySPCrc_h
+#define FrskySPCrc_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * The Smart Port "CRC" is not a real CRC, but the one's complement of an end-around carry sum (the carry out of bit 7
+ * is added back to bit 0). This makes it:
+ * * order independent - it can be updated byte per byte, while the bytes are produced or received,
+ * * cheap to compute at compile time, for constant packets and for the physical IDs of the poll,
+ * * cheap to compute on wide words - the bytes can be summed in any width, and folded to 8 bits at the end.
+ *
+ * A packet is valid when the sum of its 8 bytes (type, logical ID, value and CRC) is 0xFF.
+ *
+ * Incremental use:
+ * ~~~~~
+ * FrskySPCrc crc;
+ * for (i=0; i<7; i++) { FrskySP.write (packet[i]); crc.update (packet[i]); }
+ * FrskySP.write (crc.crc ());
+ * ~~~~~
+ *
+ * \brief Smart Port CRC engine (compile time, incremental and bulk)
+ * \see https://github.com/opentx/opentx/blob/next/radio/src/telemetry/frsky_sport.cpp
+ */
+class FrskySPCrc {
+    public:
+        constexpr FrskySPCrc () : _sum (0) {}
+
+        void    reset ()            { this->_sum = 0; }
+        void    update (uint8_t b)  { this->_sum = step (this->_sum, b); }
+        void    update (const uint8_t *buf, uint8_t len);
+        uint8_t crc () const        { return ~this->_sum; }         //!<CRC of the bytes given so far
+        bool    valid () const      { return this->_sum == 0xFF; }  //!<true if the bytes given so far end with a valid CRC
+
+        /**
+         * \brief Add one byte to an end-around carry sum
+         * \param sum current sum
+         * \param b byte to add
+         */
+        static constexpr uint8_t step (uint8_t sum, uint8_t b) {
+            return fold ((uint16_t) sum + b);
+        }
+
+        /**
+         * \brief Fold a wide sum of bytes to its 8 bits end-around carry sum
+         * \param sum sum of bytes (any number of bytes, up to 0xFFFF)
+         */
+        static constexpr uint8_t fold (uint16_t sum) {
+            return _fold8 (_fold8 (sum));
+        }
+
+        /**
+         * Usable in constant expressions, ex. to send a constant packet without computing anything at runtime.
+         * \brief CRC of a packet
+         * \param type value type (0x10)
+         * \param id sensor logical ID
+         * \param val value
+         */
+        static constexpr uint8_t packet (uint8_t type, uint16_t id, uint32_t val) {
+            return ~fold ((uint16_t) type + (id & 0xff) + (id >> 8)
+                          + (val & 0xff) + (val >> 8 & 0xff) + (val >> 16 & 0xff) + (val >> 24));
+        }
+
+        /**
+         * The 5 lower bits are the ID, the 3 upper bits are parity bits. Usable in constant expressions, ex. as
+         * \a case label after a poll header:
+         * ~~~~~
+         * case FrskySPCrc::physicalId (4):  // 0xE4
+         * ~~~~~
+         * \brief Byte sent by the receiver to poll a physical ID
+         * \param id physical ID (0~27)
+         */
+        static constexpr uint8_t physicalId (uint8_t id) {
+            return (id & 0x1f)
+                 | ((id ^ id >> 1 ^ id >> 2) & 1) << 5
+                 | ((id >> 2 ^ id >> 3 ^ id >> 4) & 1) << 6
+                 | ((id ^ id >> 2 ^ id >> 4) & 1) << 7;
+        }
+
+        static size_t check (const uint8_t *packets, size_t count, uint8_t *valid = NULL);
+
+    private:
+        static constexpr uint16_t _fold8 (uint16_t sum) { return (sum & 0xff) + (sum >> 8); }
+
+        uint8_t _sum;                                               //!<end-around carry sum
+};
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * \file FrskySPDecoder.cpp
+ */
+
+#include "FrskySPDecoder.h"
+#include "FrskySP.h"
+
+/**
+ * A poll header ends the answer before it: an answer of 1~7 bytes is reported then (\ref FRSKY_SP_EVENT_SHORT),
+ * instead of the header. No answer at all is not an event (the physical ID is not present).
+ * \brief Feed the decoder with one byte of the bus
+ * \param b byte
+ * \return event completed by this byte (\ref FRSKY_SP_EVENT_NONE ~ \ref FRSKY_SP_EVENT_BAD_ID)
+ */
+uint8_t FrskySPDecoder::feed (uint8_t b) {
+    uint8_t len = this->_len;
+
+    if (b == FRSKY_SP_POLL) {
+        this->_state  = 1;
+        this->_len    = 0;
+        this->_escape = false;
+        if (len == 0 || len >= 8) return FRSKY_SP_EVENT_NONE;
+        FrskySPStats::count (this->_stats.underflows);
+        return FRSKY_SP_EVENT_SHORT;
+    }
+
+    switch (this->_state) {
+        case 0:                             // wait for a poll
+            return FRSKY_SP_EVENT_NONE;
+
+        case 1:                             // physical ID
+            if ((b & 0x1f) >= FRSKY_SP_PHYSICAL_IDS || FrskySPCrc::physicalId (b & 0x1f) != b) {
+                this->_state  = 0;
+                this->_polled = -1;
+                FrskySPStats::count (this->_stats.dropped);
+                return FRSKY_SP_EVENT_BAD_ID;
+            }
+            this->_state  = 2;
+            this->_polled = b & 0x1f;
+            FrskySPStats::count (this->_stats.polls[b & 0x1f]);
+            return FRSKY_SP_EVENT_POLL;
+    }
+
+    if (b == FRSKY_SP_STUFF && !this->_escape) {
+        this->_escape = true;
+        return FRSKY_SP_EVENT_NONE;
+    }
+    if (this->_escape) {
+        this->_escape = false;
+        b ^= 0x20;                          // 0x5E -> 0x7E, 0x5D -> 0x7D
+        FrskySPStats::count (this->_stats.unstuffed);
+    }
+
+    if (len >= 8) {
+        if (len > 8) return FRSKY_SP_EVENT_NONE;
+        this->_len = 9;                     // reported once
+        FrskySPStats::count (this->_stats.overflows);
+        return FRSKY_SP_EVENT_LONG;
+    }
+    this->_buf[len++] = b;
+    this->_len = len;
+    if (len < 8) return FRSKY_SP_EVENT_NONE;
+
+    if (!FrskySPCrc::check (this->_buf, 1)) {
+        FrskySPStats::count (this->_stats.crcErrors);
+        return FRSKY_SP_EVENT_BAD_CRC;
+    }
+    FrskySPStats::count (this->_stats.replies);
+    if (this->_buf[0] == 0 && this->id () == 0 && this->value () == 0) {
+        FrskySPStats::count (this->_stats.empty);
+        return FRSKY_SP_EVENT_EMPTY;
+    }
+    return FRSKY_SP_EVENT_PACKET;
+}
+
+/**
+ * \brief Forget the bytes received so far (ex. after a gap in a capture)
+ */
+void FrskySPDecoder::reset () {
+    this->_len    = 0;
+    this->_state  = 0;
+    this->_escape = false;
+    this->_polled = -1;
+}
+
+/**
+ * \brief Clear the bus health counters (see FrskySPStats)
+ */
+void FrskySPDecoder::statsReset () {
+    this->_stats = FrskySPStats ();
+}
+
+/**
+ * \brief Value of the last answer
+ * \return value (32 bits, see FrskySP.h for the formats)
+ */
+uint32_t FrskySPDecoder::value () const {
+    return (uint32_t) this->_buf[3] | (uint32_t) this->_buf[4] << 8 | (uint32_t) this->_buf[5] << 16
+         | (uint32_t) this->_buf[6] << 24;
+}
@@ -0,0 +1,56 @@
+/**
+ * \file FrskySPDecoder.h
+ */
+
+#ifndef FrskySPDecoder_h
+#define FrskySPDecoder_h
+
+#include <stdint.h>
+#include "FrskySPStats.h"
+
+#define FRSKY_SP_EVENT_NONE     0           //!<nothing completed by this byte
+#define FRSKY_SP_EVENT_POLL     1           //!<poll of a valid physical ID (see FrskySPDecoder::polled())
+#define FRSKY_SP_EVENT_PACKET   2           //!<answer with a valid CRC (see FrskySPDecoder::packet())
+#define FRSKY_SP_EVENT_EMPTY    3           //!<empty answer (type 0, ID 0, value 0, CRC 0xFF)
+#define FRSKY_SP_EVENT_BAD_CRC  4           //!<answer with a wrong CRC
+#define FRSKY_SP_EVENT_SHORT    5           //!<answer cut by the next poll (1~7 bytes)
+#define FRSKY_SP_EVENT_LONG     6           //!<more than 8 bytes after a poll (ex. 2 sensors on the same physical ID)
+#define FRSKY_SP_EVENT_BAD_ID   7           //!<poll header followed by an invalid physical ID
+
+/**
+ * Where FrskySP::feed() only looks for the polls, the decoder follows the whole bus, as a sniffer or a gateway sees
+ * it: the polls of the receiver, and the answers of the sensors, unstuffed (see \ref FRSKY_SP_STUFF) and checked.
+ * feed() is O(1) per byte, and tells what the byte completed.
+ *
+ * ~~~~~
+ * FrskySPDecoder bus;
+ *
+ * while (FrskySP.available ()) {
+ *   if (bus.feed (FrskySP.read ()) == FRSKY_SP_EVENT_PACKET) Serial.println (bus.value ());
+ * }
+ * ~~~~~
+ *
+ * \brief Smart Port stream decoder (polls and answers)
+ */
+class FrskySPDecoder {
+    public:
+        uint8_t        feed (uint8_t b);
+        uint16_t       id () const          { return this->_buf[1] | this->_buf[2] << 8; }  //!<logical ID of the last answer
+        const uint8_t *packet () const      { return this->_buf; }  //!<last answer, unstuffed (8 bytes)
+        int8_t         polled () const      { return this->_polled; }   //!<last physical ID polled (-1 = none)
+        void           reset ();
+        FrskySPStats   stats () const       { return this->_stats; }    //!<snapshot of the bus health counters
+        void           statsReset ();
+        uint8_t        type () const        { return this->_buf[0]; }   //!<type of the last answer
+        uint32_t       value () const;
+
+    private:
+        uint8_t           _buf[8] = {};                             //!<answer being received
+        uint8_t           _len = 0;                                 //!<bytes in _buf (9: too long)
+        uint8_t           _state = 0;                               //!<0: wait for a poll, 1: physical ID, 2: answer
+        bool              _escape = false;                          //!<last byte was a stuffing marker
+        int8_t            _polled = -1;                             //!<see polled()
+        FrskySPStats      _stats = {};                              //!<see stats()
+};
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * \file FrskySPFreq.cpp
+ */
+
+#include "FrskySPFreq.h"
+
+/**
+ * \brief Class constructor - the first gate is FRSKY_SP_FREQ_GATE_MAX ms long
+ */
+FrskySPFreq::FrskySPFreq () {
+}
+
+/**
+ * \brief Take the count of a gate into account
+ * \param pulses pulses counted during the last gate of gate() ms
+ * \return true if gate() changed: restart the counter with the new gate
+ */
+bool FrskySPFreq::count (uint32_t pulses) {
+    const uint8_t mask = FRSKY_SP_FREQ_HISTORY - 1;
+    uint32_t last, t, span = 0, gap, p = 0, rpm;
+    uint16_t gate = this->_gate;
+    uint8_t i;
+
+    this->_now   += this->_gate;
+    this->_total += pulses;
+
+    if (pulses) {
+        // the entries are kept FRSKY_SP_FREQ_SPAN / 7 ms apart at least: the last one is moved, until it is far enough
+        if (this->_valid < 2 || this->_now - this->_history[(uint8_t) (this->_head - 2) & mask].time >=
+                FRSKY_SP_FREQ_SPAN / (FRSKY_SP_FREQ_HISTORY - 1)) {
+            this->_head++;
+            if (this->_valid < FRSKY_SP_FREQ_HISTORY) this->_valid++;
+        }
+        this->_history[(uint8_t) (this->_head - 1) & mask].time   = this->_now;
+        this->_history[(uint8_t) (this->_head - 1) & mask].pulses = this->_total;
+    }
+
+    rpm = 0;
+    if (this->_valid) {
+        last = this->_history[(uint8_t) (this->_head - 1) & mask].time;
+        gap  = this->_now - last;
+        for (i=1, t=last; i<this->_valid; i++) {
+            if (t - this->_history[(uint8_t) (this->_head - 1 - i) & mask].time > this->_timeout + this->_gate) break;
+            t = this->_history[(uint8_t) (this->_head - 1 - i) & mask].time;
+            if (span && last - t > FRSKY_SP_FREQ_SPAN) break;
+            span = last - t;
+            p    = this->_total - this->_history[(uint8_t) (this->_head - 1 - i) & mask].pulses;
+        }
+
+        if (gap > this->_timeout) {
+            p = 0;                                                  // stopped
+        } else if (p && gap * p > span) {
+            span = gap;                                             // slowing down: the next edge is already late
+            p    = 1;
+        }
+        // rpm = _k * p / span, without overflow (span < 2^14)
+        if (p) rpm = this->_k / span * p + this->_k % span * p / span;
+    }
+    this->_rpm = rpm;
+
+    if (this->_period) {
+        if (span && p * FRSKY_SP_FREQ_GATE_MAX >= (uint32_t) FRSKY_SP_FREQ_PULSES * span) {
+            this->_period = false;                                  // the longest gate would hold the pulses again
+            this->_gate   = FRSKY_SP_FREQ_GATE_MAX;
+        }
+    } else if (pulses >= 2 * FRSKY_SP_FREQ_PULSES && this->_gate > FRSKY_SP_FREQ_GATE_MIN) {
+        this->_gate /= 2;
+    } else if (pulses < FRSKY_SP_FREQ_PULSES / 2) {
+        if (this->_gate < FRSKY_SP_FREQ_GATE_MAX) {
+            this->_gate *= 2;
+        } else {
+            this->_period = true;
+            this->_gate   = FRSKY_SP_FREQ_TICK;
+        }
+    }
+    return this->_gate != gate;
+}
+
+/**
+ * \brief Set the ratio between the pulses and the revolutions (see FrskySPRpm::ratio())
+ * \param pulses pulses...
+ * \param revs ...per revs revolutions
+ */
+void FrskySPFreq::ratio (uint16_t pulses, uint16_t revs) {
+    if (!pulses || !revs) return;
+    this->_k = 60000UL * revs / pulses;
+}
+
+/**
+ * \brief Set the timeout: a longer period between 2 pulses reads 0
+ * \param ms timeout [ms] (1 ~ 10000, FRSKY_SP_RPM_TIMEOUT by default)
+ */
+void FrskySPFreq::timeout (uint16_t ms) {
+    if (ms < 1) ms = 1;
+    if (ms > 10000) ms = 10000;
+    this->_timeout = ms;
+}
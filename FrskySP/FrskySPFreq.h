@@ -0,0 +1,108 @@
+/**
+ * \file FrskySPFreq.h
+ */
+
+#ifndef FrskySPFreq_h
+#define FrskySPFreq_h
+
+#include <stdint.h>
+#include "FrskySPRpm.h"
+
+/**
+ * \brief Pulses per gate aimed at, when counting (see FrskySPFreq)
+ */
+#define FRSKY_SP_FREQ_PULSES    32
+
+/**
+ * Must be a power of 2.
+ * \brief Shortest counting gate [ms]
+ */
+#define FRSKY_SP_FREQ_GATE_MIN  8
+
+/**
+ * Must be a power of 2. A slower rate is measured by period.
+ * \brief Longest counting gate [ms]
+ */
+#define FRSKY_SP_FREQ_GATE_MAX  128
+
+/**
+ * Longer than an answer sent by SoftwareSerial (1.4 ms, interrupts disabled), so that loop() reads every count.
+ * \brief Gate when measuring by period [ms]: the resolution of the edge times
+ */
+#define FRSKY_SP_FREQ_TICK      4
+
+/**
+ * \brief Longest time averaged [ms]
+ */
+#define FRSKY_SP_FREQ_SPAN      500
+
+/**
+ * Must be a power of 2.
+ * \brief Number of gate ends kept by a FrskySPFreq
+ */
+#define FRSKY_SP_FREQ_HISTORY   8
+
+/**
+ * A gate counter (ex. the FreqCount library) counts the pulses during a fixed time: a 1 s gate gives 1 value per
+ * second, and ±1 pulse of resolution, ie. 6 % at 1000 rpm with one pulse per turn. FrskySPFreq chooses the gate
+ * instead, from the last count:
+ * * counting - the gate is the shortest one that still holds FRSKY_SP_FREQ_PULSES pulses (FRSKY_SP_FREQ_GATE_MIN ~
+ *   FRSKY_SP_FREQ_GATE_MAX ms, halved or doubled after each gate): at high rates, a value comes every 8 ms,
+ * * by period - when even the longest gate holds less than half of it, the gate is FRSKY_SP_FREQ_TICK ms, and only
+ *   tells when the edges came: the RPM is the number of pulses between 2 gates with edges, over the time between
+ *   them, known to 4 ms instead of 1 pulse. It goes back to counting when the longest gate would hold the pulses
+ *   again.
+ *
+ * In both ways, the value is averaged on the gates of the last FRSKY_SP_FREQ_SPAN ms, and follows the same rules as
+ * FrskySPRpm: integers only, a period longer than the timeout reads 0, and a late edge makes the value drop.
+ * ~~~~~
+ * FrskySPFreq freq;
+ * FrskySPSlot slot (FRSKY_SP_RPM);
+ *
+ * void setup () {
+ *   FrskySP.attach (4, &slot);                 // physical ID 4 (0xE4)
+ *   FreqCount.begin (freq.gate ());
+ * }
+ *
+ * void loop () {
+ *   if (FreqCount.available ()) {
+ *     if (freq.count (FreqCount.read ())) {    // the gate changed
+ *       FreqCount.end ();
+ *       FreqCount.begin (freq.gate ());
+ *     }
+ *     slot.set (freq.rpm ());                  // sent as is at the next poll
+ *   }
+ *   FrskySP.update ();
+ * }
+ * ~~~~~
+ *
+ * \brief Frequency counter with an adaptive gate
+ */
+class FrskySPFreq {
+    public:
+        FrskySPFreq ();
+
+        bool     count (uint32_t pulses);
+        uint16_t gate () const          { return this->_gate; }     //!<length of the next gate [ms]
+        bool     isPeriod () const      { return this->_period; }   //!<true if measuring by period
+        void     ratio (uint16_t pulses, uint16_t revs = 1);
+        uint32_t rpm () const           { return this->_rpm; }      //!<RPM at the last count()
+        void     timeout (uint16_t ms);
+
+    private:
+        struct {
+            uint32_t      time;                                     //!<gate end [ms]
+            uint32_t      pulses;                                   //!<pulses counted until then
+        } _history[FRSKY_SP_FREQ_HISTORY];                          //!<ends of the last gates with pulses (ring)
+        uint8_t           _head = 0;                                //!<next entry of _history
+        uint8_t           _valid = 0;                               //!<entries of _history written
+        uint32_t          _now = 0;                                 //!<sum of the gates [ms]
+        uint32_t          _total = 0;                               //!<sum of the pulses
+        uint16_t          _gate = FRSKY_SP_FREQ_GATE_MAX;           //!<see gate()
+        bool              _period = false;                          //!<see isPeriod()
+        uint16_t          _timeout = FRSKY_SP_RPM_TIMEOUT;          //!<longest period [ms]
+        uint32_t          _k = 60000UL;                             //!<ms per minute, per pulse: rpm = _k / period [ms]
+        uint32_t          _rpm = 0;                                 //!<see rpm()
+};
+
+#endif
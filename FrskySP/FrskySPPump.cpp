@@ -0,0 +1,74 @@
+/**
+ * \file FrskySPPump.cpp
+ */
+
+#include "Arduino.h"
+#include "FrskySPPump.h"
+
+/**
+ * \brief Add a bus (see add())
+ * \param bus bus
+ * \param step its step()
+ * \return false if FRSKY_SP_PUMP_BUSES buses are already served
+ */
+bool FrskySPPump::_add (void *bus, Step step) {
+    if (this->_count >= FRSKY_SP_PUMP_BUSES) return false;
+    this->_buses[this->_count].bus     = bus;
+    this->_buses[this->_count].step    = step;
+    this->_buses[this->_count].stepMax = 0;
+    this->_count++;
+    return true;
+}
+
+/**
+ * The guarantee holds for the steps measured so far: run the pump under the worst load (all the buses answering,
+ * queues full) before trusting it.
+ * \brief Longest wait of a bus for its next step, while in run()
+ * \param i bus index (order of add())
+ * \return sum of the longest steps of the other buses [µs]
+ */
+uint32_t FrskySPPump::latency (uint8_t i) const {
+    uint32_t sum = 0;
+    uint8_t j;
+
+    for (j=0; j<this->_count; j++) {
+        if (j != i) sum += this->_buses[j].stepMax;
+    }
+    return sum;
+}
+
+/**
+ * \brief Clear the longest step measures
+ */
+void FrskySPPump::reset () {
+    uint8_t i;
+
+    for (i=0; i<this->_count; i++) this->_buses[i].stepMax = 0;
+}
+
+/**
+ * Rounds go on until no bus has anything to do, or FRSKY_SP_PUMP_ROUNDS rounds were done (the rest waits for the next
+ * call, so that loop() is never starved).
+ * \brief Serve the buses, one step each per round
+ * \return true if a bus did something
+ */
+bool FrskySPPump::run () {
+    bool busy, any = false;
+    unsigned long start, us;
+    uint8_t round, k, i;
+
+    for (round=0; round<FRSKY_SP_PUMP_ROUNDS; round++) {
+        busy = false;
+        for (k=0, i=this->_first; k<this->_count; k++, i = i + 1 < this->_count ? i + 1 : 0) {
+            start = micros ();
+            if (!this->_buses[i].step (this->_buses[i].bus)) continue;
+            us = micros () - start;
+            if (us > this->_buses[i].stepMax) this->_buses[i].stepMax = us > 0xffff ? 0xffff : us;
+            busy = true;
+        }
+        if (++this->_first >= this->_count) this->_first = 0;
+        if (!busy) break;
+        any = true;
+    }
+    return any;
+}
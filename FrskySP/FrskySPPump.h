@@ -0,0 +1,91 @@
+/**
+ * \file FrskySPPump.h
+ */
+
+#ifndef FrskySPPump_h
+#define FrskySPPump_h
+
+#include <stdint.h>
+
+/**
+ * \brief Maximum number of buses served by a FrskySPPump
+ */
+#define FRSKY_SP_PUMP_BUSES  4
+
+/**
+ * \brief Maximum number of rounds of one FrskySPPump::run() (a SoftwareSerial receive buffer)
+ */
+#define FRSKY_SP_PUMP_ROUNDS 64
+
+/**
+ * Serves several buses from one loop(): FrskySP buses, FrskyD lines, or any object with a `bool step ()` method that
+ * does one bounded piece of work (one byte received, one answer, one byte sent) and tells if it did something.
+ *
+ * run() calls the buses in turn, one step each per round, until none has anything left to do. The first bus of a
+ * round rotates, so that none is always served first. A bus with a burst of bytes waiting then does not delay the
+ * others by more than one step per round.
+ *
+ * The pump measures the longest step of each bus (stepMax()). The longest time a bus may wait for its next step, while
+ * in run(), is the sum of the longest steps of the other buses (latency()): compare it to the answer window of the
+ * Smart Port buses (about 2 bytes, ~350 µs after the poll, minus the turnaround of the transport).
+ * ~~~~~
+ * FrskySPSerial<HardwareSerial> bus1 (Serial1), bus2 (Serial2);
+ * FrskyDSerial<HardwareSerial>  line (Serial3);
+ * FrskySP sp1 (bus1), sp2 (bus2);
+ * FrskyD  d (line);
+ * FrskySPPump pump;
+ *
+ * void setup () {
+ *   ...
+ *   d.async ();                    // FrskyD::sendData() only queues
+ *   pump.add (sp1);
+ *   pump.add (sp2);
+ *   pump.add (d);
+ * }
+ *
+ * void loop () {
+ *   pump.run ();
+ *   ...
+ * }
+ * ~~~~~
+ *
+ * \warning SoftwareSerial receives on one object at a time (the last one opened, see SoftwareSerial::listen()), and
+ * disables the interrupts while it sends or receives a byte: on AVR, at most one bus can use it. Use the hardware
+ * UARTs, or AltSoftSerial, for the others (see FrskySPSerial).
+ *
+ * \brief Fair, non-blocking service of several buses
+ */
+class FrskySPPump {
+    public:
+        /**
+         * \brief Add a bus
+         * \tparam B bus class (FrskySP, FrskyD, or any class with bool step ())
+         * \param bus bus
+         * \return false if FRSKY_SP_PUMP_BUSES buses are already served
+         */
+        template <class B> bool add (B &bus) {
+            return this->_add (&bus, &FrskySPPump::_step<B>);
+        }
+
+        uint8_t  count () const         { return this->_count; }    //!<number of buses
+        uint32_t latency (uint8_t i) const;
+        void     reset ();
+        bool     run ();
+        uint16_t stepMax (uint8_t i) const { return i < this->_count ? this->_buses[i].stepMax : 0; }  //!<longest step of bus i [µs]
+
+    private:
+        typedef bool (*Step) (void *bus);   //!<calls the step() method of a bus
+
+        template <class B> static bool _step (void *bus) { return static_cast<B *> (bus)->step (); }
+        bool     _add (void *bus, Step step);
+
+        struct {
+            void     *bus;                                          //!<bus object
+            Step      step;                                         //!<its step()
+            uint16_t  stepMax;                                      //!<longest step [µs] (saturated)
+        } _buses[FRSKY_SP_PUMP_BUSES];                              //!<buses served
+        uint8_t  _count = 0;                                        //!<number of buses
+        uint8_t  _first = 0;                                        //!<first bus of the next round
+};
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * \file FrskySPRpm.cpp
+ */
+
+#include "Arduino.h"
+#include "FrskySPRpm.h"
+
+/**
+ * \brief Class constructor
+ * \param window edge periods averaged (1 ~ FRSKY_SP_RPM_EDGES / 2): more is smoother, less follows the speed faster
+ */
+FrskySPRpm::FrskySPRpm (uint8_t window) {
+    if (window < 1) window = 1;
+    if (window > FRSKY_SP_RPM_EDGES / 2) window = FRSKY_SP_RPM_EDGES / 2;
+    this->_window = window;
+}
+
+/**
+ * \brief Record an edge, at micros() - from the interrupt
+ */
+void FrskySPRpm::edge () {
+    this->edge (micros ());
+}
+
+/**
+ * The ratio tells how many edges are seen per revolution of the stage to report, as a fraction:
+ * * propeller with 2 blades, optical sensor: ratio (2),
+ * * helicopter main rotor, sensor on the motor (1 pulse per turn), 8.5:1 reducer: ratio (17, 2),
+ * * brushless sensor on a 14 poles motor (7 pulses per turn): ratio (7).
+ * \brief Set the ratio between the edges and the revolutions
+ * \param pulses edges... (1 by default)
+ * \param revs ...per revs revolutions (1 ~ 71)
+ */
+void FrskySPRpm::ratio (uint16_t pulses, uint16_t revs) {
+    if (!pulses || !revs || revs > 71) return;
+    this->_k = 60000000UL * revs / pulses;
+}
+
+/**
+ * \brief Set the timeout: a longer period between 2 edges reads 0
+ * \param ms timeout [ms] (1 ~ 10000, FRSKY_SP_RPM_TIMEOUT by default)
+ */
+void FrskySPRpm::timeout (uint16_t ms) {
+    if (ms < 1) ms = 1;
+    if (ms > 10000) ms = 10000;
+    this->_timeout = ms * 1000UL;
+}
+
+/**
+ * The interrupt is never disabled: the ring is read from the last edge backwards, and read again if the interrupt
+ * wrote over the timestamps being read meanwhile.
+ * \brief Compute the RPM from the last edges - from loop()
+ * \return true if rpm() changed
+ */
+bool FrskySPRpm::update () {
+    uint32_t last, prev, t, span, gap, rpm;
+    uint8_t h, n, i, tries;
+
+    for (tries=0; tries<3; tries++) {
+        h = this->_head;
+        i = h - this->_seen;
+        this->_valid = i >= FRSKY_SP_RPM_EDGES - this->_valid ? FRSKY_SP_RPM_EDGES : this->_valid + i;
+        this->_seen = h;
+        if (!this->_valid) return false;
+
+        last = this->_edges[(uint8_t) (h - 1) & (FRSKY_SP_RPM_EDGES - 1)];
+        gap  = micros () - last;
+        span = 0;
+        n    = 0;
+        for (i=1, t=last; i<this->_valid && n<this->_window; i++) {
+            prev = this->_edges[(uint8_t) (h - 1 - i) & (FRSKY_SP_RPM_EDGES - 1)];
+            if (t - prev > this->_timeout) break;
+            span += t - prev;
+            t = prev;
+            n++;
+        }
+        if ((uint8_t) (this->_head - h) < FRSKY_SP_RPM_EDGES - i) break;  // the timestamps read were not overwritten
+    }
+    if (tries >= 3 || (n && !span)) return false;                   // edges too close to tell (glitch): value kept
+
+    if (gap > this->_timeout) {
+        n = 0;                                                      // stopped
+    } else if (n && gap * n > span) {
+        span = gap;                                                 // slowing down: the next edge is already late
+        n    = 1;
+    }
+    // rpm = _k * n / span, without overflow (span < 2^28, n <= 16)
+    rpm = n ? this->_k / span * n + this->_k % span * n / span : 0;
+
+    if (rpm == this->_rpm) return false;
+    this->_rpm = rpm;
+    return true;
+}
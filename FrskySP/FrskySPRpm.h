@@ -0,0 +1,90 @@
+/**
+ * \file FrskySPRpm.h
+ */
+
+#ifndef FrskySPRpm_h
+#define FrskySPRpm_h
+
+#include <stdint.h>
+
+/**
+ * Must be a power of 2, and at least twice the longest window.
+ * \brief Number of edge timestamps kept by a FrskySPRpm
+ */
+#define FRSKY_SP_RPM_EDGES      32
+
+/**
+ * \brief Default window of a FrskySPRpm [edge periods]
+ */
+#define FRSKY_SP_RPM_WINDOW     8
+
+/**
+ * A slower sensor reads 0 (the brushless sensor triggers 1~10 pulses per second when the motor is stopped).
+ * \brief Default timeout of a FrskySPRpm: longest period between 2 edges [ms]
+ */
+#define FRSKY_SP_RPM_TIMEOUT    100
+
+/**
+ * The interrupt only timestamps the edge, in a ring: the RPM is computed in update(), from the periods between the
+ * last edges. A period is known at each edge, so the value follows the speed at the edge rate (a 1-second gate
+ * counting pulses gives 1 value per second, and ±1 pulse of resolution).
+ *
+ * update() averages the last periods (the window, FRSKY_SP_RPM_WINDOW by default), and stops at a period longer than
+ * the timeout: after a stop, the value is computed on the new edges only. When no edge came for longer than the last
+ * periods, the value drops with the time since the last edge, and reads 0 after the timeout.
+ *
+ * The computation is done with integers (µs and rpm), without any float: update() takes a few µs on AVR.
+ * ~~~~~
+ * FrskySPRpm  rpm;
+ * FrskySPSlot slot (FRSKY_SP_RPM);
+ *
+ * void rpmISR () { rpm.edge (); }
+ *
+ * void setup () {
+ *   rpm.ratio (17, 2);                         // 8.5 pulses per revolution (sensor on the motor, 8.5:1 reducer)
+ *   attachInterrupt (0, rpmISR, FALLING);
+ *   FrskySP.attach (4, &slot);                 // physical ID 4 (0xE4)
+ * }
+ *
+ * void loop () {
+ *   if (rpm.update ()) slot.set (rpm.rpm ());
+ *   FrskySP.update ();
+ * }
+ * ~~~~~
+ * With FrskyD, the value goes in the hub frame 1: `frame1.set (FRSKY_D_RPM, min (rpm.rpm (), 60000UL))`.
+ *
+ * An input capture interrupt gives the time of the edge itself, without the interrupt latency: pass it to edge(us),
+ * in µs.
+ *
+ * \brief RPM computed from the periods between edges
+ */
+class FrskySPRpm {
+    public:
+        FrskySPRpm (uint8_t window = FRSKY_SP_RPM_WINDOW);
+
+        void     edge ();
+        /**
+         * \brief Record an edge - from the interrupt
+         * \param us time of the edge [µs] (micros() or input capture)
+         */
+        void     edge (uint32_t us) {
+            this->_edges[this->_head & (FRSKY_SP_RPM_EDGES - 1)] = us;
+            this->_head = this->_head + 1;
+        }
+        void     ratio (uint16_t pulses, uint16_t revs = 1);
+        uint32_t rpm () const           { return this->_rpm; }      //!<RPM at the last update()
+        void     timeout (uint16_t ms);
+        bool     update ();
+
+    private:
+        volatile uint32_t _edges[FRSKY_SP_RPM_EDGES];               //!<edge timestamps (ring) [µs]
+        volatile uint8_t  _head = 0;                                //!<edges recorded (modulo 256), next slot of the ring
+        uint8_t           _seen = 0;                                //!<_head at the last update()
+        uint8_t           _valid = 0;                               //!<timestamps of the ring that were written
+        uint8_t           _window;                                  //!<edge periods averaged
+        uint32_t          _k = 60000000UL;                          //!<µs per minute, per pulse: rpm = _k / period [µs]
+        uint32_t          _timeout = FRSKY_SP_RPM_TIMEOUT * 1000UL; //!<longest period [µs]
+        uint32_t          _rpm = 0;                                 //!<see rpm()
+};
+
+#endif
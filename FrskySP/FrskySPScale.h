@@ -0,0 +1,94 @@
+/**
+ * \file FrskySPScale.h
+ */
+
+#ifndef FrskySPScale_h
+#define FrskySPScale_h
+
+#include <stdint.h>
+
+/**
+ * Converts an integer reading (ex. mV, cm, mph) to the integer a value format expects (ex. V * 500, m * 100,
+ * knots * 10), with a rational scale N / D known at compile time. No float, and no division at runtime: N / D is
+ * reduced and turned into an integer part and a 31 bits multiplier when compiling, and the conversion costs 2 or 3
+ * 16x16 bits multiplications, a fraction of the float formula on an ATmega328 (no soft-float call). The float code of
+ * libgcc is not linked in at all if no float is used elsewhere.
+ *
+ * The result is exact (the same as the integer formula val * N / D, without overflow) for every input within
+ * -MAX ~ MAX: this is checked when compiling. If a scale does not compile, lower MAX.
+ *
+ * Usual scales:
+ *
+ * value                       | input            | scale
+ * --------------------------- | ---------------- | --------------------------------------
+ * \ref FRSKY_SP_CELLS (V*500) | mV               | FrskySPScale<1, 2> (see FrskySP::lipoCellMv())
+ * \ref FRSKY_SP_VFAS (V*100)  | mV               | FrskySPScale<1, 10>
+ * \ref FRSKY_SP_CURR (A*10)   | mA               | FrskySPScale<1, 100>
+ * \ref FRSKY_SP_ALT (m*100)   | dm               | FrskySPScale<10>
+ * \ref FRSKY_SP_GPS_SPEED     | km/h             | FrskySPScale<1000000, 1852, 3000> (knots * 1000)
+ * \ref FRSKY_SP_AIR_SPEED     | mph              | FrskySPScale<16093440, 1852000> (knots * 10)
+ * \ref FRSKY_SP_AIR_SPEED     | km/h             | FrskySPScale<10000, 1852> (knots * 10)
+ *
+ * ~~~~~
+ * airspeed.set (FrskySPScale<16093440, 1852000>::round (mph));  // same as mph * 10 / 1.15077945 + 0.5
+ * ~~~~~
+ *
+ * \brief Compile-time rational scale, float-free
+ * \tparam N numerator
+ * \tparam D denominator
+ * \tparam MAX highest absolute input value (32767 at most)
+ */
+template <uint32_t N, uint32_t D = 1, uint16_t MAX = 32767> class FrskySPScale {
+    private:
+        static constexpr uint32_t _gcd (uint32_t a, uint32_t b) { return b ? _gcd (b, a % b) : a; }
+
+    public:
+        static constexpr uint32_t num = N / _gcd (N, D);                            //!<reduced numerator
+        static constexpr uint32_t den = D / _gcd (N, D);                            //!<reduced denominator
+        static constexpr uint32_t q   = num / den;                                  //!<integer part
+        static constexpr uint32_t rem = num % den;                                  //!<fractional part (rem / den)
+        static constexpr uint32_t mul = (((uint64_t) rem << 31) + den - 1) / den;   //!<ceil (rem / den * 2^31)
+        static constexpr uint64_t err = (uint64_t) mul * den - ((uint64_t) rem << 31);  //!<rounding error of mul
+
+        static_assert (D != 0, "null denominator");
+        static_assert (MAX <= 32767, "MAX is limited to 16 bits signed inputs");
+        static_assert ((uint64_t) q * MAX + 1 < 0x80000000UL, "the result overflows 31 bits: lower MAX");
+        static_assert (err * MAX < 0x80000000UL, "not exact over -MAX ~ MAX: lower MAX");
+
+        /**
+         * Truncated toward 0, as the float formula cast to an integer: (int32_t) (val * N / D).
+         * \brief Scale an integer
+         * \param val input (-MAX ~ MAX)
+         * \return val * N / D
+         */
+        static int32_t encode (int16_t val) {
+            uint16_t u = val < 0 ? -val : val;
+            uint32_t r = q * u + _frac (u, 0);
+            return val < 0 ? -(int32_t) r : (int32_t) r;
+        }
+
+        /**
+         * Rounded half away from 0, as the float formula + 0.5 cast to an integer (for positive values).
+         * \brief Scale an integer, rounded
+         * \param val input (-MAX ~ MAX)
+         * \return val * N / D, rounded
+         */
+        static int32_t round (int16_t val) {
+            static_assert (2 * err * MAX < 0x80000000UL, "rounding not exact over -MAX ~ MAX: lower MAX");
+            uint16_t u = val < 0 ? -val : val;
+            uint32_t r = q * u + _frac (u, 0x40000000UL);
+            return val < 0 ? -(int32_t) r : (int32_t) r;
+        }
+
+    private:
+        /**
+         * (u * mul + half) >> 31, with 16x16 bits multiplications only (mul < 2^31, u < 2^15)
+         */
+        static uint32_t _frac (uint16_t u, uint32_t half) {
+            if (rem == 0) return 0;
+            return ((uint32_t) u * (uint16_t) (mul >> 16) + (((uint32_t) u * (uint16_t) mul + (half & 0xffff)) >> 16)
+                    + (half >> 16)) >> 15;
+        }
+};
+
+#endif
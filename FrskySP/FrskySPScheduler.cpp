@@ -0,0 +1,108 @@
+/**
+ * \file FrskySPScheduler.cpp
+ */
+
+#include "Arduino.h"
+#include "FrskySP.h"
+#include "FrskySPScheduler.h"
+
+/**
+ * \brief Class constructor
+ * \param bus bus to update between the tasks
+ */
+FrskySPScheduler::FrskySPScheduler (FrskySP &bus) : _bus (bus) {
+}
+
+/**
+ * A task of unknown cost first runs early in the poll period, where the slack is the largest: its cost is known from
+ * then on.
+ * \brief Add a task
+ * \param task task
+ * \param period period [ms] (0 = at every gap)
+ * \param cost longest run expected [µs] (0 = unknown, measured)
+ * \return false if FRSKY_SP_TASKS tasks are already registered
+ */
+bool FrskySPScheduler::add (FrskySPTask task, uint16_t period, uint16_t cost) {
+    if (this->_count >= FRSKY_SP_TASKS) return false;
+    this->_tasks[this->_count].task   = task;
+    this->_tasks[this->_count].period = period;
+    this->_tasks[this->_count].cost   = cost;
+    this->_tasks[this->_count].last   = millis () - period;
+    this->_count++;
+    return true;
+}
+
+/**
+ * \brief Clear slackMin() and overruns() (the costs and the period are kept)
+ */
+void FrskySPScheduler::reset () {
+    this->_slackMin = FRSKY_SP_SLACK_NONE;
+    this->_overruns = 0;
+}
+
+/**
+ * \brief Update the bus, and run the tasks that are due and fit before the next poll
+ * \return last physical ID polled (0~27), -1 if none (see FrskySP::update())
+ */
+int FrskySPScheduler::run () {
+    unsigned long start, us;
+    int32_t left, need;
+    int id, r;
+    uint8_t k, i;
+
+    start = micros ();                      // the poll was received before: the next one is expected earlier, not later
+    id = this->_bus.update ();
+    if (id >= 0) this->_poll (start);
+
+    for (k=0, i=this->_next; k<this->_count; k++, i = i + 1 < this->_count ? i + 1 : 0) {
+        if (this->_tasks[i].period && millis () - this->_tasks[i].last < this->_tasks[i].period) continue;
+        left = this->slack ();
+        need = this->_tasks[i].cost ? this->_tasks[i].cost : this->_period / 2;
+        if (need + FRSKY_SP_SLACK_MARGIN > left) continue;
+
+        start = micros ();
+        this->_tasks[i].task ();
+        us = micros () - start;
+        this->_tasks[i].last = millis ();
+        if (us > this->_tasks[i].cost) this->_tasks[i].cost = us > 0xffff ? 0xffff : us;
+        if (this->_polled && (int32_t) us > left && this->_overruns < 0xffff) this->_overruns++;
+
+        start = micros ();
+        r = this->_bus.update ();
+        if (r >= 0) {
+            id = r;
+            this->_poll (start);
+        }
+        left = this->slack ();
+        if (this->_polled && left < this->_slackMin) this->_slackMin = left;
+    }
+    if (++this->_next >= this->_count) this->_next = 0;
+    return id;
+}
+
+/**
+ * The polls are periodic: the next one is expected one period after the last one seen, or a whole number of periods
+ * after it if some were not seen.
+ * \brief Time left before the next expected poll
+ * \return time [µs] (FRSKY_SP_SLACK_NONE until a poll is seen)
+ */
+int32_t FrskySPScheduler::slack () const {
+    if (!this->_polled) return FRSKY_SP_SLACK_NONE;
+    return this->_period - (int32_t) ((micros () - this->_lastPoll) % this->_period);
+}
+
+/**
+ * The period follows the intervals close to it (within 50 %), with a 1/8 filter: a poll seen late, or a gap, does not
+ * change it much.
+ * \brief Take a poll into account
+ * \param now micros() when the poll was seen
+ */
+void FrskySPScheduler::_poll (unsigned long now) {
+    unsigned long interval = now - this->_lastPoll;
+
+    if (this->_polled && interval > this->_period / 2U && interval < this->_period * 3UL / 2) {
+        this->_period += ((int32_t) interval - (int32_t) this->_period) / 8;
+    }
+    this->_lastPoll = now;
+    this->_polled   = true;
+}
@@ -0,0 +1,100 @@
+/**
+ * \file FrskySPScheduler.h
+ */
+
+#ifndef FrskySPScheduler_h
+#define FrskySPScheduler_h
+
+#include <stdint.h>
+
+class FrskySP;
+
+/**
+ * \brief Maximum number of tasks of a FrskySPScheduler
+ */
+#define FRSKY_SP_TASKS          8
+
+/**
+ * \brief Poll period assumed until it is measured [µs]
+ */
+#define FRSKY_SP_POLL_PERIOD    11000
+
+/**
+ * \brief Time kept free before the next expected poll [µs] (poll period jitter, time to see the poll)
+ */
+#define FRSKY_SP_SLACK_MARGIN   500
+
+/**
+ * \brief slack() until a poll is seen
+ */
+#define FRSKY_SP_SLACK_NONE     0x7fffffffL
+
+/**
+ * Task of a FrskySPScheduler: one short step of a sensor (start a conversion, read an I2C register, one ADC burst).
+ * A long operation (ex. a DS18x20 conversion, 750 ms) is split in steps: the task keeps its state, and each call does
+ * the next step.
+ */
+typedef void (*FrskySPTask) ();
+
+/**
+ * The receiver polls one physical ID every 11~12 ms, and the answer must start within a few hundreds of µs: a sensor
+ * read done in loop() just before a poll makes the answer late. The scheduler follows the polls seen by the bus, and
+ * runs a task only if it can end before the next expected poll.
+ *
+ * run() updates the bus (see FrskySP::update()), then runs the tasks that are due, in turn, as long as their cost (the
+ * longest run measured, or the cost given to add()) fits in the time left (slack()), minus FRSKY_SP_SLACK_MARGIN. The
+ * bus is updated again after each task. A task that does not fit waits for the next gap. A task of unknown cost only
+ * runs in the first half of the poll period, until its first run tells its cost.
+ *
+ * The poll period is measured on the polls seen. Until a first poll is seen, the tasks run as soon as they are due.
+ * ~~~~~
+ * FrskySPScheduler tasks (FrskySP);
+ *
+ * void readAirspeed () { airspeed.set (read_sensor ()); }            // 756 µs
+ *
+ * void setup () {
+ *   tasks.add (readAirspeed, 100, 800);                            // every 100 ms, 800 µs at most
+ * }
+ *
+ * void loop () {
+ *   tasks.run ();                                                  // instead of FrskySP.update ()
+ * }
+ * ~~~~~
+ * slackMin() tells how close the tasks went to the next poll: it should stay above 0. overruns() counts the tasks that
+ * ran over an expected poll (longer than their cost).
+ *
+ * \brief Runs slow sensor steps between the Smart Port polls
+ */
+class FrskySPScheduler {
+    public:
+        FrskySPScheduler (FrskySP &bus);
+
+        bool     add (FrskySPTask task, uint16_t period = 0, uint16_t cost = 0);
+        uint16_t cost (uint8_t i) const     { return i < this->_count ? this->_tasks[i].cost : 0; }    //!<longest run of task i [µs]
+        uint16_t overruns () const          { return this->_overruns; } //!<tasks that ran over an expected poll
+        uint16_t period () const            { return this->_period; }   //!<measured poll period [µs]
+        void     reset ();
+        int      run ();
+        int32_t  slack () const;
+        int32_t  slackMin () const          { return this->_slackMin; } //!<smallest slack() left by the tasks since reset() [µs]
+
+    private:
+        void     _poll (unsigned long now);
+
+        struct {
+            FrskySPTask   task;                                     //!<task function
+            uint16_t      period;                                   //!<period [ms] (0 = at every gap)
+            uint16_t      cost;                                     //!<longest run [µs]
+            unsigned long last;                                     //!<millis() at the last run
+        } _tasks[FRSKY_SP_TASKS];                                   //!<tasks
+        FrskySP          &_bus;                                     //!<bus updated between the tasks
+        uint8_t           _count = 0;                               //!<number of tasks
+        uint8_t           _next = 0;                                //!<first task tried by the next run()
+        bool              _polled = false;                          //!<a poll was seen
+        unsigned long     _lastPoll = 0;                            //!<micros() at the last poll seen
+        uint16_t          _period = FRSKY_SP_POLL_PERIOD;           //!<see period()
+        uint16_t          _overruns = 0;                            //!<see overruns()
+        int32_t           _slackMin = FRSKY_SP_SLACK_NONE;          //!<see slackMin()
+};
+
+#endif
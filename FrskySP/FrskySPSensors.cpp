@@ -0,0 +1,52 @@
+/**
+ * \file FrskySPSensors.cpp
+ */
+
+#include "FrskySP.h"
+
+constexpr FrskySPSensor FrskySPSensors::table[];
+
+/**
+ * \brief Row of a logical ID, at runtime (binary search)
+ * \param id logical ID
+ * \return row, NULL if the ID is unknown
+ */
+const FrskySPSensor *FrskySPSensors::lookup (uint16_t id) {
+    uint8_t lo = 0, hi = count, mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (id < table[mid].id)                          hi = mid;
+        else if (id >= table[mid].id + table[mid].range) lo = mid + 1;
+        else return &table[mid];
+    }
+    return NULL;
+}
+
+/**
+ * format                | result
+ * --------------------- | ------------------------------------------
+ * FRSKY_SP_FORMAT_INT   | quantity (value / scale)
+ * FRSKY_SP_FORMAT_CELLS | voltage of the first cell of the packet
+ * FRSKY_SP_FORMAT_GPS   | coordinate [°], negative for S and W
+ * FRSKY_SP_FORMAT_RAW   | value as is
+ *
+ * \brief Decode a received value with its row (see FrskySPCodec to decode at compile time)
+ * \param sensor row (see lookup())
+ * \param val received value
+ * \return quantity (unit of the row)
+ */
+float FrskySPSensors::value (const FrskySPSensor &sensor, uint32_t val) {
+    float f;
+
+    switch (sensor.format) {
+        case FRSKY_SP_FORMAT_CELLS:
+            return (float) (val >> 8 & 0x0fff) / sensor.scale;
+        case FRSKY_SP_FORMAT_GPS:
+            f = (float) (val & 0x3fffffff) / 600000;
+            return val & 0x40000000 ? -f : f;
+        case FRSKY_SP_FORMAT_RAW:
+            return val;
+    }
+    return sensor.isSigned ? (float) (int32_t) val / sensor.scale : (float) val / sensor.scale;
+}
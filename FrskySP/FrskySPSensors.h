@@ -0,0 +1,168 @@
+/**
+ * \file FrskySPSensors.h
+ */
+
+#ifndef FrskySPSensors_h
+#define FrskySPSensors_h
+
+#include <stdint.h>
+
+#define FRSKY_SP_FORMAT_INT     0           //!<integer: value = quantity * scale
+#define FRSKY_SP_FORMAT_CELLS   1           //!<2 lipo cells (see FrskySP::lipoCell())
+#define FRSKY_SP_FORMAT_GPS     2           //!<GPS coordinate (bit 31: longitude, bit 30: S/W, minutes * 10000)
+#define FRSKY_SP_FORMAT_RAW     3           //!<unknown format, 32 bits as is
+
+/**
+ * \brief Descriptor of a Smart Port sensor (see FrskySPSensors)
+ */
+struct FrskySPSensor {
+    uint16_t    id;                         //!<first logical ID
+    uint8_t     range;                      //!<number of logical IDs (id ~ id + range - 1)
+    int8_t      physical;                   //!<usual physical ID (-1 if unknown)
+    uint16_t    scale;                      //!<value = quantity * scale (FRSKY_SP_FORMAT_INT, FRSKY_SP_FORMAT_CELLS)
+    bool        isSigned;                   //!<the value is signed
+    uint8_t     format;                     //!<FRSKY_SP_FORMAT_INT ~ FRSKY_SP_FORMAT_RAW
+    const char *name;                       //!<short name
+    const char *unit;                       //!<unit of the quantity ("" if none)
+};
+
+/**
+ * The logical IDs are documented one by one in FrskySP.h - this table holds the same, in a form the code can use:
+ * range, physical ID, scale, unit and signedness. It is sorted by ID (checked when compiling): adding a sensor is
+ * adding its row.
+ *
+ * At compile time, FrskySPCodec gives the encoder and the decoder of one ID. At runtime (ex. in a sniffer),
+ * lookup() finds the row of any logical ID with a binary search, and value() decodes it.
+ * ~~~~~
+ * const FrskySPSensor *s = FrskySPSensors::lookup (id);
+ * if (s) Serial << s->name << ": " << FrskySPSensors::value (*s, val) << " " << s->unit << endl;
+ * ~~~~~
+ *
+ * \brief Smart Port sensor table
+ */
+class FrskySPSensors {
+    public:
+        static constexpr FrskySPSensor table[] = {
+            //  ID                     range phys scale  signed format                 name           unit
+            {FRSKY_SP_ALT,             16,   0,   100,   true,  FRSKY_SP_FORMAT_INT,   "Alt",         "m"},
+            {FRSKY_SP_VARIO,           16,   0,   100,   true,  FRSKY_SP_FORMAT_INT,   "Vario",       "m/s"},
+            {FRSKY_SP_CURR,            16,   2,   10,    false, FRSKY_SP_FORMAT_INT,   "Curr",        "A"},
+            {FRSKY_SP_VFAS,            16,   2,   100,   false, FRSKY_SP_FORMAT_INT,   "VFAS",        "V"},
+            {FRSKY_SP_CELLS,           16,   1,   500,   false, FRSKY_SP_FORMAT_CELLS, "Cells",       "V"},
+            {FRSKY_SP_T1,              16,   -1,  1,     true,  FRSKY_SP_FORMAT_INT,   "T1",          "C"},
+            {FRSKY_SP_T2,              16,   -1,  1,     true,  FRSKY_SP_FORMAT_INT,   "T2",          "C"},
+            {FRSKY_SP_RPM,             16,   4,   1,     false, FRSKY_SP_FORMAT_INT,   "RPM",         "rpm"},
+            {FRSKY_SP_FUEL,            16,   -1,  1,     false, FRSKY_SP_FORMAT_INT,   "Fuel",        "%"},
+            {FRSKY_SP_ACCX,            16,   -1,  100,   true,  FRSKY_SP_FORMAT_INT,   "AccX",        "g"},
+            {FRSKY_SP_ACCY,            16,   -1,  100,   true,  FRSKY_SP_FORMAT_INT,   "AccY",        "g"},
+            {FRSKY_SP_ACCZ,            16,   -1,  100,   true,  FRSKY_SP_FORMAT_INT,   "AccZ",        "g"},
+            {FRSKY_SP_GPS_LONG_LATI,   16,   3,   1,     false, FRSKY_SP_FORMAT_GPS,   "GPS",         ""},
+            {FRSKY_SP_GPS_ALT,         16,   3,   100,   true,  FRSKY_SP_FORMAT_INT,   "GAlt",        "m"},
+            {FRSKY_SP_GPS_SPEED,       16,   3,   1000,  false, FRSKY_SP_FORMAT_INT,   "GSpd",        "knots"},
+            {FRSKY_SP_GPS_COURSE,      16,   3,   100,   false, FRSKY_SP_FORMAT_INT,   "Hdg",         "deg"},
+            {FRSKY_SP_GPS_TIME_DATE,   16,   3,   1,     false, FRSKY_SP_FORMAT_RAW,   "Date",        ""},
+            {FRSKY_SP_A3,              16,   5,   1,     false, FRSKY_SP_FORMAT_RAW,   "A3",          ""},
+            {FRSKY_SP_A4,              16,   5,   1,     false, FRSKY_SP_FORMAT_RAW,   "A4",          ""},
+            {FRSKY_SP_AIR_SPEED,       16,   -1,  10,    false, FRSKY_SP_FORMAT_INT,   "ASpd",        "knots"},
+            {FRSKY_SP_RSSI_ID,         1,    -1,  1,     false, FRSKY_SP_FORMAT_INT,   "RSSI",        "dB"},
+            {FRSKY_SP_ADC1_ID,         1,    -1,  1,     false, FRSKY_SP_FORMAT_RAW,   "A1",          ""},
+            {FRSKY_SP_ADC2_ID,         1,    -1,  1,     false, FRSKY_SP_FORMAT_RAW,   "A2",          ""},
+            {FRSKY_SP_BATT_ID,         1,    -1,  1,     false, FRSKY_SP_FORMAT_RAW,   "BATT",        ""},
+            {FRSKY_SP_SWR_ID,          1,    -1,  1,     false, FRSKY_SP_FORMAT_RAW,   "SWR",         ""},
+        };
+
+        static constexpr uint8_t count = sizeof (table) / sizeof (table[0]);   //!<number of rows
+
+        /**
+         * \brief Row of a logical ID, at compile time
+         * \param id logical ID
+         * \param i first row to check
+         * \return row index, count if the ID is unknown
+         */
+        static constexpr uint8_t find (uint16_t id, uint8_t i = 0) {
+            return i >= count ? count : id >= table[i].id && id < table[i].id + table[i].range ? i : find (id, i + 1);
+        }
+
+        /**
+         * \brief Check the table order (and that the ranges do not overlap)
+         */
+        static constexpr bool sorted (uint8_t i = 1) {
+            return i >= count ? true : table[i - 1].id + table[i - 1].range <= table[i].id && sorted (i + 1);
+        }
+
+        static const FrskySPSensor *lookup (uint16_t id);
+        static float                value (const FrskySPSensor &sensor, uint32_t val);
+};
+
+static_assert (FrskySPSensors::sorted (), "FrskySPSensors::table must be sorted by ID, without overlaps");
+
+/**
+ * Encoder and decoder of a logical ID, from its row in FrskySPSensors: the scale is known when compiling, and an
+ * unknown ID does not compile.
+ *
+ * The integer encoder takes the quantity in 1/DIV units (ex. cm for meters: DIV 100), and costs a multiplication or
+ * a division only if the scale and DIV differ. One of them must divide the other (checked when compiling): for any
+ * other ratio, use FrskySPScale (ex. FrskySPScale<500, 1024> for an ADC reading).
+ * ~~~~~
+ * alt.set (FrskySPCodec<FRSKY_SP_ALT>::encode<100> (cm));         // m * 100: cm as is
+ * vfas.set (FrskySPCodec<FRSKY_SP_VFAS>::encode<1000> (mv));      // V * 100: mV / 10
+ * curr.set (FrskySPCodec<FRSKY_SP_CURR>::encodeFloat (amps));    // A * 10
+ * ~~~~~
+ *
+ * \brief Compile-time sensor codec (Smart Port)
+ * \tparam ID logical ID
+ */
+template <uint16_t ID> class FrskySPCodec {
+    public:
+        static constexpr uint8_t  index    = FrskySPSensors::find (ID);         //!<row in FrskySPSensors::table
+        static_assert (index < FrskySPSensors::count, "unknown logical ID: add it to FrskySPSensors::table");
+
+        static constexpr uint16_t scale    = FrskySPSensors::table[index].scale;    //!<value = quantity * scale
+        static constexpr int8_t   physical = FrskySPSensors::table[index].physical; //!<usual physical ID
+        static constexpr bool     isSigned = FrskySPSensors::table[index].isSigned; //!<signed value
+
+        /**
+         * \brief Encode a quantity given in 1/DIV units, truncated toward 0
+         * \tparam DIV input resolution (ex. 1000 for mV, when the unit is V) - a divisor or a multiple of the scale
+         * \param val quantity * DIV
+         * \return value to send
+         */
+        template <uint32_t DIV = 1> static int32_t encode (int32_t val) {
+            static_assert (scale % DIV == 0 || DIV % scale == 0, "scale and DIV do not divide evenly: use FrskySPScale");
+            return scale % DIV == 0 ? val * (int32_t) (scale / DIV) : val / (int32_t) (DIV / scale);
+        }
+
+        /**
+         * \brief Encode a quantity
+         * \param val quantity (unit of the table)
+         * \return value to send
+         */
+        static int32_t encodeFloat (float val) {
+            return val * scale;
+        }
+
+        /**
+         * \brief Decode a received value, in 1/MUL units, truncated toward 0
+         * \tparam MUL output resolution (ex. 1000 for mV, when the unit is V) - a divisor or a multiple of the scale
+         * \param val received value
+         * \return quantity * MUL
+         */
+        template <uint32_t MUL = 1> static int32_t decode (uint32_t val) {
+            static_assert (MUL % scale == 0 || scale % MUL == 0, "scale and MUL do not divide evenly: use FrskySPScale");
+            return MUL % scale == 0 ? _signed (val) * (int32_t) (MUL / scale) : _signed (val) / (int32_t) (scale / MUL);
+        }
+
+        /**
+         * \brief Decode a received value
+         * \param val received value
+         * \return quantity (unit of the table)
+         */
+        static float decodeFloat (uint32_t val) {
+            return isSigned ? (float) (int32_t) val / scale : (float) val / scale;
+        }
+
+    private:
+        static int32_t _signed (uint32_t val) { return isSigned ? (int32_t) val : (int32_t) (val & 0x7fffffff); }
+};
+
+#endif
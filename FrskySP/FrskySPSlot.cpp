@@ -0,0 +1,137 @@
+/**
+ * \file FrskySPSlot.cpp
+ */
+
+#include "FrskySPSlot.h"
+#include "FrskySPCrc.h"
+#include "FrskySPStuffing.h"
+
+#define _barrier() __asm__ __volatile__ ("" ::: "memory")  // keep the buffer accesses between the sequence accesses
+
+/**
+ * \brief Slot constructor (no value yet - nothing is sent until set() is called)
+ * \param id sensor logical ID (see FrskySP.h)
+ * \param type value type (always 0x10 at now)
+ */
+FrskySPSlot::FrskySPSlot (uint16_t id, uint8_t type) {
+    this->_id   = id;
+    this->_type = type;
+}
+
+/**
+ * The default is priority 1, and 1000 ms.
+ * \brief Set the scheduling parameters (see \ref FrskySPSlot)
+ * \param priority priority (1~255, higher is more important)
+ * \param maxAge maximum age [ms] (11~32767) - an unchanged value is sent again after this time
+ */
+void FrskySPSlot::schedule (uint8_t priority, uint16_t maxAge) {
+    uint32_t weight;
+
+    if (maxAge < 11)     maxAge = 11;       // poll cycle
+    if (maxAge > 0x7fff) maxAge = 0x7fff;
+    weight = (uint32_t) priority * 4096 / maxAge;
+
+    this->_maxAge = maxAge;
+    this->_weight = (weight == 0) ? 1 : (weight > 0xffff) ? 0xffff : weight;
+}
+
+/**
+ * Can be called from an interrupt. If the packet is the same as the current one, nothing is changed (the slot is not
+ * seen as changed by the scheduler).
+ * \brief Encode a new value
+ * \param val value (preformated, see FrskySP.h)
+ */
+void FrskySPSlot::set (int32_t val) {
+    uint8_t    seq = this->_seq + 1;
+    uint8_t   *p;
+    uint8_t    i;
+    FrskySPCrc crc;
+
+    if (seq == 0) seq = 2;                  // 0 means "never set", and the buffer parity must be kept
+    p = this->_buf[seq & 1];
+
+    p[0] = this->_type;
+    p[1] = this->_id;
+    p[2] = this->_id >> 8;
+    p[3] = val;
+    p[4] = val >> 8;
+    p[5] = val >> 16;
+    p[6] = val >> 24;
+    crc.update (p, 7);
+    p[7] = crc.crc ();
+    this->_mask[seq & 1] = FrskySPStuffing::mask (p);
+
+    if (this->_seq) {
+        for (i=0; i<8 && p[i] == this->_buf[this->_seq & 1][i]; i++);
+        if (i == 8) return;                 // same packet
+    }
+
+    _barrier ();
+    this->_seq = seq;                       // publish
+}
+
+/**
+ * \brief Encode a new value, with another logical ID (ex. FRSKY_SP_ALT+1)
+ * \param id sensor logical ID
+ * \param val value
+ */
+void FrskySPSlot::set (uint16_t id, int32_t val) {
+    this->_id = id;
+    this->set (val);
+}
+
+/**
+ * \brief Copy the last packet encoded by set()
+ * \param packet destination (8 bytes)
+ * \param mask if not NULL, receives the bytes of the packet to stuff (see FrskySPStuffing::stuff())
+ * \return sequence number of the packet copied
+ */
+uint8_t FrskySPSlot::copy (uint8_t *packet, uint8_t *mask) const {
+    uint8_t seq;
+    uint8_t i;
+
+    do {
+        seq = this->_seq;
+        _barrier ();
+        for (i=0; i<8; i++) packet[i] = this->_buf[seq & 1][i];
+        if (mask) *mask = this->_mask[seq & 1];
+        _barrier ();
+    } while ((uint8_t) (this->_seq - seq) >= 2);    // the buffer was reused while copying
+    return seq;
+}
+
+/**
+ * \brief Pick the slot to send on a poll (see \ref FrskySPSlot)
+ * \param list first slot attached to the polled physical ID
+ * \param now time [ms] (16 bits are enough)
+ * \return slot to send, NULL if none (nothing set, or nothing changed and nothing too old)
+ */
+FrskySPSlot *FrskySPSlot::pick (FrskySPSlot *list, uint16_t now) {
+    FrskySPSlot *best = 0;
+    uint32_t     bestScore = 0;
+    uint32_t     score;
+    uint16_t     age;
+
+    for (; list; list = list->_next) {
+        if (!list->isSet ()) continue;
+        age = (list->_sentSeq == 0) ? 0x7fff : now - list->_sentAt;
+        if (age > 0x7fff) age = 0x7fff;
+        if (!list->isChanged () && age < list->_maxAge) continue;
+        score = (uint32_t) age * list->_weight + 1;
+        if (score > bestScore) {
+            best = list;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+/**
+ * \brief Record the sending of a packet (called by FrskySP)
+ * \param seq sequence number of the packet sent (see copy())
+ * \param now time [ms]
+ */
+void FrskySPSlot::_sent (uint8_t seq, uint16_t now) {
+    this->_sentSeq = seq;
+    this->_sentAt  = now;
+}
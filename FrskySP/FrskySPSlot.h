@@ -0,0 +1,76 @@
+/**
+ * \file FrskySPSlot.h
+ */
+
+#ifndef FrskySPSlot_h
+#define FrskySPSlot_h
+
+#include <stdint.h>
+
+/**
+ * A slot holds a packet that is ready to be sent: type, logical ID, value and CRC are encoded when the value is set,
+ * not when the receiver polls, and so are the bytes to stuff (see FrskySPStuffing). The answer to a poll is then a
+ * plain copy of 8 bytes, stuffed while copied (see FrskySP::attach()).
+ *
+ * The slot is double-buffered: set() encodes in the buffer that is not read, and switches the buffers when done. A
+ * sequence number tells the reader if the buffer it has copied was overwritten meanwhile (set() called twice, ex.
+ * from an interrupt), in which case the copy is done again. A torn packet can never be sent.
+ *
+ * ~~~~~
+ * FrskySPSlot rpm (FRSKY_SP_RPM);
+ *
+ * FrskySP.attach (4, &rpm);   // physical ID 4 (0xE4)
+ * rpm.set (11111);             // whenever the value changes
+ * ~~~~~
+ *
+ * Scheduling
+ * ----------
+ * Several slots can be attached to the same physical ID (ex. GPS altitude, speed and course), but only one can be
+ * sent per poll. Instead of a blind round-robin, each poll sends the slot that is the most overdue:
+ * * a slot whose value did not change since it was sent is skipped, until it reaches its maximum age (it is then sent
+ *   again, so that OpenTX does not lose it),
+ * * among the others, the score is the time since the last sending, relative to the maximum age, times the priority.
+ *
+ * ~~~~~
+ * FrskySPSlot gpsAlt (FRSKY_SP_GPS_ALT);
+ * FrskySPSlot gpsSpeed (FRSKY_SP_GPS_SPEED);
+ *
+ * gpsSpeed.schedule (2, 500);  // twice as important, at least every 500 ms
+ * FrskySP.attach (3, &gpsAlt);
+ * FrskySP.attach (3, &gpsSpeed);
+ * ~~~~~
+ *
+ * \brief Pre-encoded Smart Port packet
+ */
+class FrskySPSlot {
+    friend class FrskySP;
+
+    public:
+        FrskySPSlot (uint16_t id, uint8_t type = 0x10);
+
+        uint8_t  copy (uint8_t *packet, uint8_t *mask = 0) const;
+        bool     isChanged () const     { return this->_seq != this->_sentSeq; }     //!<true if set since last sent
+        bool     isSet () const         { return this->_seq != 0; }                 //!<true once a value was set
+        uint16_t id () const            { return this->_id; }                       //!<logical ID
+        void     schedule (uint8_t priority, uint16_t maxAge);
+        void     set (int32_t val);
+        void     set (uint16_t id, int32_t val);
+
+        static FrskySPSlot *pick (FrskySPSlot *list, uint16_t now);
+
+    private:
+        void     _sent (uint8_t seq, uint16_t now);
+
+        uint8_t           _buf[2][8];                               //!<packets, _buf[_seq & 1] is the one to send
+        uint8_t           _mask[2];                                 //!<bytes of each packet to stuff (see FrskySPStuffing)
+        volatile uint8_t  _seq = 0;                                 //!<incremented by each set() (0 = never set)
+        uint16_t          _id;                                      //!<logical ID
+        uint8_t           _type;                                    //!<value type
+        uint8_t           _sentSeq = 0;                             //!<_seq of the last packet sent
+        uint16_t          _sentAt = 0;                              //!<time of the last sending [ms] (16 bits)
+        uint16_t          _maxAge = 1000;                           //!<maximum age [ms]
+        uint16_t          _weight = 4096 / 1000;                    //!<priority * 4096 / maximum age
+        FrskySPSlot      *_next = 0;                                //!<next slot on the same physical ID
+};
+
+#endif
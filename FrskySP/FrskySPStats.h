@@ -0,0 +1,60 @@
+/**
+ * \file FrskySPStats.h
+ */
+
+#ifndef FrskySPStats_h
+#define FrskySPStats_h
+
+#include <stdint.h>
+
+/**
+ * Defined here, as the size of FrskySPStats::polls (FrskySP.h includes it).
+ * \brief Number of physical IDs polled by the receiver (0~27)
+ */
+#define FRSKY_SP_PHYSICAL_IDS   28
+
+/**
+ * Link quality counters, kept by FrskySP (sensor side) and FrskySPDecoder (whole bus). All the counters saturate at
+ * 65535: take a snapshot with stats(), and clear them with statsReset(), ex. once per minute.
+ *
+ * counter    | FrskySP                                     | FrskySPDecoder
+ * ---------- | ------------------------------------------- | -------------------------------------------------
+ * polls      | polls per physical ID                       | polls per physical ID
+ * replies    | answers sent (empty ones included)          | valid answers (empty ones included)
+ * empty      | empty answers sent (FrskySP::keepAlive())   | empty answers
+ * crcErrors  | CRCcheck() failures                         | answers with a wrong CRC
+ * overflows  | RX buffer overflows (see FrskySPTransport)  | answers longer than 8 bytes (2 sensors on one ID)
+ * underflows | polls of an answered ID left without answer | answers cut by the next poll (sensor too slow)
+ * unstuffed  | -                                           | stuffed bytes (see \ref FRSKY_SP_STUFF)
+ * echoes     | echoes given up (see the transports)        | -
+ * dropped    | poll headers with a bad physical ID         | poll headers with a bad physical ID
+ *
+ * ~~~~~
+ * FrskySPStats s = FrskySP.stats ();
+ * FrskySP.statsReset ();
+ * if (s.underflows) Serial.println ("sensor too slow");
+ * ~~~~~
+ *
+ * \brief Bus health counters (Smart Port)
+ */
+struct FrskySPStats {
+    uint16_t polls[FRSKY_SP_PHYSICAL_IDS];  //!<polls seen, per physical ID
+    uint16_t replies;                       //!<answers sent / seen
+    uint16_t empty;                         //!<empty answers sent / seen
+    uint16_t crcErrors;                     //!<CRC failures
+    uint16_t overflows;                     //!<RX buffer overflows / answers too long
+    uint16_t underflows;                    //!<polls left without answer / answers cut
+    uint16_t unstuffed;                     //!<stuffed bytes received
+    uint16_t echoes;                        //!<echoes of the answers given up (transport)
+    uint16_t dropped;                       //!<poll headers with a bad physical ID
+
+    /**
+     * \brief Saturating increment
+     * \param counter counter
+     */
+    static void count (uint16_t &counter) {
+        if (counter != 0xffff) counter++;
+    }
+};
+
+#endif
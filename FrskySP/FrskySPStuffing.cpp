@@ -0,0 +1,55 @@
+/**
+ * \file FrskySPStuffing.cpp
+ */
+
+#include "FrskySPStuffing.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * \brief Find the bytes of a packet to stuff
+ * \param packet packet (8 bytes: type, logical ID, value, CRC)
+ * \return bit i set if byte i is 0x7E or 0x7D (0: nothing to stuff)
+ */
+uint8_t FrskySPStuffing::mask (const uint8_t *packet) {
+#if defined(__SSE2__)
+    __m128i p = _mm_loadl_epi64 ((const __m128i *) packet);
+    __m128i m = _mm_or_si128 (_mm_cmpeq_epi8 (p, _mm_set1_epi8 (0x7E)), _mm_cmpeq_epi8 (p, _mm_set1_epi8 (0x7D)));
+
+    return _mm_movemask_epi8 (m) & 0xff;
+#else
+    uint8_t m = 0;
+    uint8_t i;
+
+    for (i=0; i<8; i++) {
+        if (FrskySPStuffing::needs (packet[i])) m |= 1 << i;
+    }
+    return m;
+#endif
+}
+
+/**
+ * The bytes are moved from the end, so that the buffer holds the packet before, and the bytes to send after.
+ * \brief Stuff a packet, in place
+ * \param buf packet in the first 8 bytes (FRSKY_SP_PACKET_MAX bytes)
+ * \param mask bytes to stuff (see mask())
+ * \return length on the wire (8 ~ FRSKY_SP_PACKET_MAX)
+ */
+uint8_t FrskySPStuffing::stuff (uint8_t *buf, uint8_t mask) {
+    uint8_t len = FrskySPStuffing::length (mask);
+    uint8_t j = len;
+    int8_t i;
+
+    if (!mask) return 8;
+    for (i=7; i>=0 && j>i; i--) {
+        if (mask & 1 << i) {
+            buf[--j] = buf[i] ^ 0x20;
+            buf[--j] = 0x7D;
+        } else {
+            buf[--j] = buf[i];
+        }
+    }
+    return len;
+}
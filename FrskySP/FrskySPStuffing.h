@@ -0,0 +1,55 @@
+/**
+ * \file FrskySPStuffing.h
+ */
+
+#ifndef FrskySPStuffing_h
+#define FrskySPStuffing_h
+
+#include <stdint.h>
+
+/**
+ * \brief Longest packet on the wire: 8 bytes, all stuffed
+ */
+#define FRSKY_SP_PACKET_MAX     16
+
+/**
+ * On the bus, 0x7E starts a poll: a 0x7E in a packet (logical ID, value or CRC) is sent as 0x7D 0x5E, and the 0x7D
+ * marker itself as 0x7D 0x5D (see \ref FRSKY_SP_STUFF). FrskySPDecoder undoes it on reception.
+ *
+ * The bytes to stuff are found once, when the packet is encoded (FrskySPSlot::set()), as a mask: the length on the
+ * wire is then known before the answer starts, and the stuffing is done in place, without any comparison, while the
+ * answer is copied. On hosts with SSE2, the mask is found by 2 compares of the 8 bytes at once.
+ * ~~~~~
+ * uint8_t buf[FRSKY_SP_PACKET_MAX];   // packet in the first 8 bytes
+ * uint8_t len = FrskySPStuffing::stuff (buf, FrskySPStuffing::mask (buf));
+ * ~~~~~
+ *
+ * \brief Smart Port byte stuffing
+ */
+class FrskySPStuffing {
+    public:
+        /**
+         * \brief Length of a packet on the wire
+         * \param mask bytes to stuff (see mask())
+         * \return 8 ~ FRSKY_SP_PACKET_MAX
+         */
+        static uint8_t length (uint8_t mask) {
+            uint8_t n = 8;
+
+            for (; mask; mask &= mask - 1) n++;
+            return n;
+        }
+
+        /**
+         * \brief Check if a byte must be stuffed
+         * \param b byte
+         */
+        static constexpr bool needs (uint8_t b) {
+            return b == 0x7E || b == 0x7D;
+        }
+
+        static uint8_t mask (const uint8_t *packet);
+        static uint8_t stuff (uint8_t *buf, uint8_t mask);
+};
+
+#endif
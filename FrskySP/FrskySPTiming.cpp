@@ -0,0 +1,99 @@
+/**
+ * \file FrskySPTiming.cpp
+ */
+
+#include "Arduino.h"
+#include "FrskySPTiming.h"
+
+/**
+ * \brief Histogram bucket of a latency (see \ref FrskySPTiming)
+ * \param us latency [µs]
+ * \return bucket (0~FRSKY_SP_TIMING_BUCKETS-1)
+ */
+uint8_t FrskySPTiming::bucketOf (uint32_t us) {
+    uint8_t i = 0;
+
+    while (us >>= 1) i++;
+    return i < FRSKY_SP_TIMING_BUCKETS ? i : FRSKY_SP_TIMING_BUCKETS - 1;
+}
+
+/**
+ * One line with the figures, then one line per non-empty bucket:
+ * ~~~~~
+ * latency: 1523 answers, p50 511 us, p99 1023 us, max 2210 us, tx max 1402 us
+ * 256~511 us: 1490
+ * 512~1023 us: 31
+ * 2048~4095 us: 2
+ * ~~~~~
+ * \brief Print the histogram on Serial
+ */
+void FrskySPTiming::dump () const {
+    uint8_t i;
+
+    Serial.print ("latency: ");
+    Serial.print ((unsigned int) this->_count);
+    Serial.print (" answers, p50 ");
+    Serial.print ((unsigned long) this->percentile (50));
+    Serial.print (" us, p99 ");
+    Serial.print ((unsigned long) this->percentile (99));
+    Serial.print (" us, max ");
+    Serial.print ((unsigned long) this->_latencyMax);
+    Serial.print (" us, tx max ");
+    Serial.print ((unsigned int) this->_txMax);
+    Serial.println (" us");
+    for (i=0; i<FRSKY_SP_TIMING_BUCKETS; i++) {
+        if (!this->_buckets[i]) continue;
+        Serial.print (i ? 1UL << i : 0UL);
+        Serial.print ('~');
+        if (i < FRSKY_SP_TIMING_BUCKETS - 1) Serial.print ((2UL << i) - 1);
+        Serial.print (" us: ");
+        Serial.println ((unsigned int) this->_buckets[i]);
+    }
+}
+
+/**
+ * The histogram only tells the bucket: the result is the upper bound of the bucket that holds the percentile, or the
+ * longest latency if lower.
+ * \brief Latency percentile
+ * \param pc percentile (1~100)
+ * \return latency [µs], 0 if nothing was measured
+ */
+uint32_t FrskySPTiming::percentile (uint8_t pc) const {
+    uint32_t target = ((uint32_t) this->_count * pc + 99) / 100;
+    uint32_t sum = 0;
+    uint8_t i;
+
+    if (!this->_count) return 0;
+    for (i=0; i<FRSKY_SP_TIMING_BUCKETS - 1; i++) {
+        sum += this->_buckets[i];
+        if (sum >= target) break;
+    }
+    if (i < FRSKY_SP_TIMING_BUCKETS - 1 && (2UL << i) - 1 < this->_latencyMax) return (2UL << i) - 1;
+    return this->_latencyMax;
+}
+
+/**
+ * \brief Clear the histogram
+ */
+void FrskySPTiming::reset () {
+    uint8_t i;
+
+    for (i=0; i<FRSKY_SP_TIMING_BUCKETS; i++) this->_buckets[i] = 0;
+    this->_count      = 0;
+    this->_latencyMax = 0;
+    this->_txMax      = 0;
+}
+
+/**
+ * \brief Count an answer (called by FrskySP)
+ * \param latency poll to first byte time [µs]
+ * \param tx sending time [µs]
+ */
+void FrskySPTiming::_add (uint32_t latency, uint32_t tx) {
+    uint16_t *b = &this->_buckets[FrskySPTiming::bucketOf (latency)];
+
+    if (*b < 0xffff) (*b)++;
+    if (this->_count < 0xffff) this->_count++;
+    if (latency > this->_latencyMax) this->_latencyMax = latency;
+    if (tx > this->_txMax) this->_txMax = tx > 0xffff ? 0xffff : tx;
+}
@@ -0,0 +1,61 @@
+/**
+ * \file FrskySPTiming.h
+ */
+
+#ifndef FrskySPTiming_h
+#define FrskySPTiming_h
+
+#include <stdint.h>
+
+/**
+ * \brief Number of histogram buckets (the last one holds 32.768 ms and more)
+ */
+#define FRSKY_SP_TIMING_BUCKETS 16
+
+/**
+ * How close a sensor is to missing its answer window: the time from the poll of a physical ID to the first byte of
+ * the answer, in a log2 histogram. Bucket 0 holds 0~1 µs, bucket n holds 2^n ~ 2^(n+1)-1 µs. The counters saturate
+ * at 65535.
+ *
+ * The receiver waits about 2 bytes (~350 µs) for an answer: a genuine sensor answers in the 256~511 µs bucket or
+ * before. A slow loop() (float math, I2C reads, DS18x20 conversions) shows as answers in the higher buckets, long
+ * before the radio reports the sensor lost.
+ *
+ * Only measured when the library is built with FRSKY_SP_TIMING set to 1 (see FrskySP::measure()).
+ * ~~~~~
+ * FrskySPTiming timing;
+ *
+ * FrskySP.measure (4, &timing);
+ * ...
+ * if (millis () - last > 10000) {
+ *   timing.dump ();
+ *   timing.reset ();
+ * }
+ * ~~~~~
+ *
+ * \brief Poll to answer latency histogram of a physical ID
+ */
+class FrskySPTiming {
+    friend class FrskySP;
+
+    public:
+        uint16_t bucket (uint8_t i) const   { return i < FRSKY_SP_TIMING_BUCKETS ? this->_buckets[i] : 0; }  //!<answers in bucket i
+        uint16_t count () const             { return this->_count; }        //!<answers measured
+        uint32_t latencyMax () const        { return this->_latencyMax; }   //!<longest poll to answer time [µs]
+        uint16_t txMax () const             { return this->_txMax; }        //!<longest answer sending time [µs]
+        void     dump () const;
+        uint32_t percentile (uint8_t pc) const;
+        void     reset ();
+
+        static uint8_t bucketOf (uint32_t us);
+
+    private:
+        void     _add (uint32_t latency, uint32_t tx);
+
+        uint16_t _buckets[FRSKY_SP_TIMING_BUCKETS] = {};            //!<answers per latency bucket
+        uint16_t _count = 0;                                        //!<answers measured (saturated)
+        uint32_t _latencyMax = 0;                                   //!<longest latency [µs]
+        uint16_t _txMax = 0;                                        //!<longest sending [µs] (saturated)
+};
+
+#endif
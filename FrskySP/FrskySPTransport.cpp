@@ -0,0 +1,199 @@
+/**
+ * \file FrskySPTransport.cpp
+ */
+
+#include "FrskySPTransport.h"
+
+/**
+ * Leaves the TX pin as INPUT: RX freeze workaround (see FrskySPSoftSerial).
+ * \brief Open the line
+ * \param speed speed [bds]
+ */
+void FrskySPSoftSerial::begin (long speed) {
+    this->_speed = speed;
+    this->serial.begin (speed);
+#ifdef FRSKY_SP_PORT_IO
+    this->_ddr  = portModeRegister (digitalPinToPort (this->_pinTx));
+    this->_mask = digitalPinToBitMask (this->_pinTx);
+#endif
+    pinMode (this->_pinTx, INPUT);
+    this->_txInput = true;
+}
+
+/**
+ * \brief Put the TX pin back as OUTPUT (RX freeze workaround, see FrskySPSoftSerial)
+ */
+void FrskySPSoftSerial::_txOutput () {
+#ifdef FRSKY_SP_PORT_IO
+    uint8_t sreg = SREG;
+
+    cli ();
+    *this->_ddr |= this->_mask;
+    SREG = sreg;
+#else
+    pinMode (this->_pinTx, OUTPUT);
+#endif
+    this->_txInput = false;
+}
+
+#ifdef FRSKY_SP_TERMIOS
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/**
+ * \brief termios speed constant of a speed
+ * \param speed speed [bds]
+ * \return speed constant (B0 if unknown)
+ */
+static speed_t _baud (long speed) {
+    switch (speed) {
+        case 9600:   return B9600;
+        case 19200:  return B19200;
+        case 38400:  return B38400;
+        case 57600:  return B57600;
+        case 115200: return B115200;
+    }
+    return B0;
+}
+
+/**
+ * The device is opened by begin().
+ * \brief Class constructor
+ * \param path device (ex. /dev/ttyUSB0, a pty slave, a fifo or a file)
+ * \param echo true if the bytes sent are received back (single wire adapter)
+ */
+FrskySPTermios::FrskySPTermios (const char *path, bool echo) {
+    this->_path = path;
+    this->_fd   = -1;
+    this->_echo = echo;
+}
+
+/**
+ * \brief Class constructor, on an open file descriptor (ex. a pty master, or stdin)
+ * \param fd file descriptor
+ * \param echo true if the bytes sent are received back (single wire adapter)
+ */
+FrskySPTermios::FrskySPTermios (int fd, bool echo) {
+    this->_path = NULL;
+    this->_fd   = fd;
+    this->_echo = echo;
+}
+
+/**
+ * \brief Number of bytes received, not read yet (never waits)
+ * \return number of bytes
+ */
+int FrskySPTermios::available () {
+    ssize_t n;
+
+    while (this->_fd >= 0) {
+        if (this->_head == this->_tail) {
+            n = ::read (this->_fd, this->_buf, sizeof (this->_buf));
+            if (n <= 0) break;
+            this->_head = 0;
+            this->_tail = n;
+        }
+        if (!this->_pending) break;
+        while (this->_pending && this->_head < this->_tail) {
+            this->_head++;                  // echo
+            this->_pending--;
+        }
+    }
+    if (this->_pending && this->_speed && micros () - this->_txEnd > 30000000UL / this->_speed + this->_turnaround) {
+        this->_pending = 0;                 // 3 byte times after the answer (and the adapter latency): no echo will come
+        this->_lost    = true;
+    }
+    return this->_pending ? 0 : this->_tail - this->_head;
+}
+
+/**
+ * A terminal is set raw, 8N1, at the given speed. Anything else (pty master, pipe, file) is read as is. The latency
+ * timer of a USB adapter (/sys/bus/usb-serial/devices/<tty>/latency_timer) is reported by turnaround().
+ * \brief Open the line
+ * \param speed speed [bds]
+ */
+void FrskySPTermios::begin (long speed) {
+    struct termios tio;
+    char  sys[64];
+    FILE *f;
+    int   ms;
+
+    this->_speed = speed;
+    if (this->_fd < 0 && this->_path) {
+        this->_fd = open (this->_path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (this->_fd < 0) this->_fd = open (this->_path, O_RDONLY | O_NONBLOCK);
+        if (this->_fd < 0) return;
+    }
+    fcntl (this->_fd, F_SETFL, fcntl (this->_fd, F_GETFL) | O_NONBLOCK);
+
+    if (tcgetattr (this->_fd, &tio) == 0) {
+        cfmakeraw (&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cc[VMIN]  = 0;
+        tio.c_cc[VTIME] = 0;
+        if (_baud (speed) != B0) {
+            cfsetispeed (&tio, _baud (speed));
+            cfsetospeed (&tio, _baud (speed));
+        }
+        tcsetattr (this->_fd, TCSANOW, &tio);
+    }
+
+    if (!this->_path || !strrchr (this->_path, '/')) return;
+    snprintf (sys, sizeof (sys), "/sys/bus/usb-serial/devices/%s/latency_timer", strrchr (this->_path, '/') + 1);
+    if ((f = fopen (sys, "r")) == NULL) return;
+    if (fscanf (f, "%d", &ms) == 1 && ms >= 0 && ms <= 65) this->_turnaround = ms * 1000;
+    fclose (f);
+}
+
+/**
+ * \brief Tell if echo bytes were given up since the last call (see FrskySPStats::echoes)
+ * \return true once after an echo did not come back
+ */
+bool FrskySPTermios::echoLost () {
+    bool r = this->_lost;
+
+    this->_lost = false;
+    return r;
+}
+
+/**
+ * \brief Next byte received (never waits)
+ * \return byte, -1 if none
+ */
+int FrskySPTermios::read () {
+    if (!this->available ()) return -1;
+    return this->_buf[this->_head++];
+}
+
+/**
+ * \brief Before an answer: give up the echo of the previous answer, if it did not come back
+ */
+void FrskySPTermios::txBegin () {
+    if (this->_pending) {
+        this->_pending = 0;                 // echo of the previous answer never came
+        this->_lost    = true;
+    }
+}
+
+/**
+ * \brief Wait until the bytes written are sent
+ */
+void FrskySPTermios::txEnd () {
+    if (this->_fd >= 0) tcdrain (this->_fd);
+    this->_txEnd = micros ();
+}
+
+/**
+ * \brief Send a byte
+ * \param val byte
+ * \return 1 if written, 0 otherwise
+ */
+size_t FrskySPTermios::write (uint8_t val) {
+    if (this->_fd < 0 || ::write (this->_fd, &val, 1) != 1) return 0;
+    if (this->_echo) this->_pending++;
+    return 1;
+}
+#endif
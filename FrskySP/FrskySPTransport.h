@@ -0,0 +1,243 @@
+/**
+ * \file FrskySPTransport.h
+ */
+
+#ifndef FrskySPTransport_h
+#define FrskySPTransport_h
+
+#include "Arduino.h"
+#include "SoftwareSerial.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+#define FRSKY_SP_TERMIOS                    //!<FrskySPTermios is available (Linux host build)
+#endif
+
+#if defined(__AVR__)
+#define FRSKY_SP_PORT_IO                    //!<FrskySPSoftSerial switches the TX pin on its port register
+#endif
+
+/**
+ * FrskySP only reaches the bus through this interface: the protocol code is the same whatever drives the line.
+ *
+ * backend              | class                           | turnaround()
+ * -------------------- | ------------------------------- | ------------------------------------------------------
+ * SoftwareSerial       | FrskySPSoftSerial (default)     | 1 bit (the RX interrupt waits for the stop bit)
+ * hardware UART        | FrskySPSerial<HardwareSerial>   | direction pin switching only
+ * AltSoftSerial        | FrskySPSerial<AltSoftSerial>    | 1 bit (the next timer compare starts the TX)
+ * Linux tty, pty, pipe | FrskySPTermios                  | USB adapter latency timer, 0 for a pty
+ *
+ * The bus is a single wire: the answer is written between txBegin() and txEnd(), for the transports that must take
+ * the line and give it back.
+ *
+ * \brief Serial line under FrskySP (see FrskySP::FrskySP(FrskySPTransport&))
+ */
+class FrskySPTransport {
+    public:
+        virtual int      available () = 0;                          //!<number of bytes received, not read yet
+        virtual void     begin (long speed) = 0;                    //!<open the line (ex. \ref FRSKY_SP_SPEED)
+        virtual int      read () = 0;                               //!<next byte received, -1 if none
+        virtual bool     echoLost () { return false; }              //!<true once after echo bytes did not come back (see FrskySPSerial)
+        virtual bool     overflow () { return false; }              //!<true once after received bytes were lost (buffer full)
+        virtual uint16_t turnaround () const = 0;                   //!<nominal delay added between a poll and its answer [µs]
+        virtual void     txBegin () {}                              //!<take the line, before an answer
+        virtual void     txEnd () {}                                //!<wait until the answer is sent, and release the line
+        virtual size_t   write (uint8_t val) = 0;                   //!<send a byte
+
+    protected:
+        long              _speed = 0;                               //!<speed [bds], set by begin()
+};
+
+/**
+ * SoftwareSerial, inverted. This is what FrskySP::FrskySP(int, int) and FrskySPPins use.
+ *
+ * With the diode between TX and RX (see the connection draft in \ref index), RX hangs after begin(). The workaround
+ * is to put the TX pin back as INPUT in begin(), and as OUTPUT when the first byte is received. The state is kept
+ * per transport, so each bus has its own. On AVR, the pin is switched on its port register (looked up by begin()),
+ * not with pinMode().
+ * \warning SoftwareSerial disables the interrupts for a whole byte, and conflicts with
+ *   [PinChangeInt] (https://code.google.com/p/arduino-pinchangeint/) - see FrskySPSerial for the alternatives.
+ * \brief SoftwareSerial transport (FrskySP)
+ */
+class FrskySPSoftSerial : public FrskySPTransport {
+    public:
+        /**
+         * \brief Class constructor
+         * \param pinRx RX pin
+         * \param pinTx TX pin
+         */
+        FrskySPSoftSerial (int pinRx, int pinTx) : serial (pinRx, pinTx, true), _pinTx (pinTx) {}
+
+        /**
+         * \brief Number of bytes received, not read yet (puts the TX pin back as OUTPUT after the first one)
+         */
+        int available () {
+            int r = this->serial.available ();
+            if (r && this->_txInput) this->_txOutput ();
+            return r;
+        }
+
+        void     begin (long speed);
+        bool     overflow ()            { return this->serial.overflow (); }
+        int      read ()                { return this->serial.read (); }
+        uint16_t turnaround () const    { return this->_speed ? 1000000L / this->_speed : 0; }
+        size_t   write (uint8_t val)    { return this->serial.write (val); }
+
+        SoftwareSerial    serial;                                   //!<SoftwareSerial object
+
+    private:
+        void     _txOutput ();
+
+        uint8_t           _pinTx;                                   //!<TX pin
+        bool              _txInput = false;                         //!<TX pin left as INPUT until the first byte received
+#ifdef FRSKY_SP_PORT_IO
+        volatile uint8_t *_ddr = NULL;                              //!<direction register of the TX pin
+        uint8_t           _mask = 0;                                //!<bit of the TX pin
+#endif
+};
+
+/**
+ * Any class with the HardwareSerial methods (begin, available, read, write, flush), ex. Serial1 or
+ * [AltSoftSerial] (http://www.pjrc.com/teensy/td_libs_AltSoftSerial.html) - much faster than SoftwareSerial, and no
+ * conflict with PinChangeInt. Neither can invert the signal: an inverter is needed between the port and the bus.
+ *
+ * RX and TX share the bus: when the line driver has an enable input, give its pin as pinDir (HIGH while sending).
+ *
+ * Whether the bytes sent are received back depends on the wiring - give echo accordingly (false by default):
+ * * echo = true - the RX of the port hears the bus while sending: single wire through a diode or a resistor, or a
+ *   transceiver whose receiver is always enabled (~RE tied low, DE driven by pinDir). The echo is dropped.
+ * * echo = false - the receiver is off while sending: transceiver with DE and ~RE tied together (driven by pinDir),
+ *   or separate TX and RX lines.
+ *
+ * An echo that does not come back (wrong echo setting, or a byte lost) is given up at the next answer, or 3 byte
+ * times after the end of the answer, and counted in FrskySPStats::echoes: the bus is never left deaf.
+ *
+ * ~~~~~
+ * FrskySPSerial<HardwareSerial> bus (Serial1, 2);                 // line driver enabled by pin 2, DE and ~RE tied
+ * FrskySPSerial<AltSoftSerial>  bus (altSerial, -1, true, 1);     // single wire (echo), starts on the next bit time
+ * FrskySP FrskySP (bus);
+ *
+ * void setup () {
+ *   bus.begin (FRSKY_SP_SPEED);
+ * }
+ * ~~~~~
+ *
+ * \brief Half-duplex transport on a serial port (FrskySP)
+ * \tparam S serial class
+ */
+template <class S> class FrskySPSerial : public FrskySPTransport {
+    public:
+        /**
+         * \brief Class constructor
+         * \param serial serial port
+         * \param pinDir line driver enable pin (-1 = none)
+         * \param echo true if the bytes sent are received back (depends on the wiring, see above)
+         * \param startBits delay of the port before it starts sending [bit times] (0 for a UART, 1 for AltSoftSerial)
+         */
+        FrskySPSerial (S &serial, int pinDir = -1, bool echo = false, uint8_t startBits = 0)
+            : _serial (serial), _pinDir (pinDir), _echo (echo), _startBits (startBits) {}
+
+        int available () {
+            while (this->_pending && this->_serial.available ()) {
+                this->_serial.read ();              // echo
+                this->_pending--;
+            }
+            if (this->_pending && this->_speed && micros () - this->_txEnd > 30000000UL / this->_speed) {
+                this->_pending = 0;                 // 3 byte times after the answer: the echo will not come
+                this->_lost    = true;
+            }
+            return this->_pending ? 0 : this->_serial.available ();
+        }
+
+        void begin (long speed) {
+            this->_speed = speed;
+            this->_serial.begin (speed);
+            if (this->_pinDir < 0) return;
+            digitalWrite (this->_pinDir, LOW);
+            pinMode (this->_pinDir, OUTPUT);
+        }
+
+        int read () {
+            return this->available () ? this->_serial.read () : -1;
+        }
+
+        uint16_t turnaround () const {
+            uint16_t us = this->_pinDir < 0 ? 0 : 5;        // digitalWrite ()
+            return this->_speed ? us + this->_startBits * 1000000L / this->_speed : us;
+        }
+
+        bool echoLost () {
+            bool r = this->_lost;
+
+            this->_lost = false;
+            return r;
+        }
+
+        void txBegin () {
+            if (this->_pending) {
+                this->_pending = 0;                 // echo of the previous answer never came
+                this->_lost    = true;
+            }
+            if (this->_pinDir >= 0) digitalWrite (this->_pinDir, HIGH);
+        }
+
+        void txEnd () {
+            this->_serial.flush ();
+            if (this->_pinDir >= 0) digitalWrite (this->_pinDir, LOW);
+            this->_txEnd = micros ();
+        }
+
+        size_t write (uint8_t val) {
+            if (this->_echo) this->_pending++;
+            return this->_serial.write (val);
+        }
+
+    private:
+        S                &_serial;                                  //!<serial port
+        int               _pinDir;                                  //!<line driver enable pin (-1 = none)
+        bool              _echo;                                    //!<the bytes sent are received back
+        uint8_t           _startBits;                               //!<see turnaround()
+        uint8_t           _pending = 0;                             //!<echo bytes not received back yet
+        bool              _lost = false;                            //!<see echoLost()
+        unsigned long     _txEnd = 0;                               //!<micros() at the end of the last answer
+};
+
+#ifdef FRSKY_SP_TERMIOS
+/**
+ * Runs FrskySP on a Linux gateway: a serial adapter (ex. /dev/ttyUSB0, inverted - FTDI chips can invert in their
+ * EEPROM), a pty, a pipe or a file. The line is raw, non-blocking: available() never waits.
+ *
+ * As with FrskySPSerial, an echo that does not come back (echo set on a line that does not loop back, or a byte lost)
+ * is given up at the next answer, or 3 byte times plus turnaround() after the end of the answer, and counted in
+ * FrskySPStats::echoes: the polls that follow are not taken for echo.
+ * \brief Linux termios transport (FrskySP, host only)
+ */
+class FrskySPTermios : public FrskySPTransport {
+    public:
+        FrskySPTermios (const char *path, bool echo = false);
+        FrskySPTermios (int fd, bool echo = false);
+
+        int      available ();
+        void     begin (long speed);
+        bool     echoLost ();
+        int      fd () const            { return this->_fd; }       //!<file descriptor (-1 if not open)
+        int      read ();
+        uint16_t turnaround () const    { return this->_turnaround; }
+        void     txBegin ();
+        void     txEnd ();
+        size_t   write (uint8_t val);
+
+    private:
+        const char       *_path;                                    //!<device path (NULL if opened by the caller)
+        int               _fd;                                      //!<file descriptor
+        bool              _echo;                                    //!<the bytes sent are received back
+        uint16_t          _pending = 0;                             //!<echo bytes not received back yet
+        bool              _lost = false;                            //!<see echoLost()
+        unsigned long     _txEnd = 0;                               //!<micros() at the end of the last answer
+        uint16_t          _turnaround = 0;                          //!<see turnaround()
+        uint8_t           _buf[64];                                 //!<bytes read, not taken yet
+        uint8_t           _head = 0;                                //!<next byte to take in _buf
+        uint8_t           _tail = 0;                                //!<end of the bytes in _buf
+};
+#endif
+
+#endif
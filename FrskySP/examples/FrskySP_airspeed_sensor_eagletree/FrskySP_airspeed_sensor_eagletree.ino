@@ -32,50 +32,47 @@
 
 FrskySP FrskySP (10, 11);
 
+/*
+ * The packet is encoded (unit conversion and CRC included) each time the sensor is read, and sent as is when the
+ * physical ID 7 (0x67) is polled.
+ */
+FrskySPSlot airspeed (FRSKY_SP_AIR_SPEED);
+
+/*
+ * The sensor read takes 756 us: it is run by the scheduler, only where it ends before the next poll.
+ */
+FrskySPScheduler tasks (FrskySP);
+
 void setup () {
   Serial.begin (115200);
   Serial.println ("BEGIN");
 
   Wire.begin();
+  FrskySP.attach (7, &airspeed);
+  tasks.add (read_airspeed, 100, 800);  // every 100 ms, 800 us at most
 }
 
 void loop () {
-  static float mph = 0;
-  static unsigned long sensor_millis = millis ();
-
-  if ((millis() - sensor_millis) >= 100) {
-    mph = read_sensor (ASP_V3);  // In third party I2C mode, the airspeed sensor returns mph
-    sensor_millis = millis ();
-    Serial.println (mph);
-  }
-
-  while (FrskySP.available ()) {
-
-    if (FrskySP.read () == 0x7E) {
-
-      while (!FrskySP.available ());  // wait for the next byte
-
-      switch (FrskySP.read ()) {
+  tasks.run ();                         // updates FrskySP too
+}
 
-        case 0x67:  // Physical ID 7
-          /*
-           * The is a little drift on OpenTX, that was discussed here:
-           * https://github.com/opentx/opentx/issues/1422
-           *
-           * Although, the value will be recored correctly, as so in Companion.
-           * Don't try to resolve the shown value on the transmitter if you want
-           * to rely on the logged values.
-           *
-           * real conversion          | value shown OpenTX 
-           * -------------------------|----------------------
-           * 1 mph = 1.15077945 knots | 23 / 20 = 1.15 (up to 2.0.5: 31 / 27 = 1.148148148)
-           * 1 kph = 1.852 knots      | 50 / 27 = 1.851851852
-           */
-          FrskySP.sendData (FRSKY_SP_AIR_SPEED, mph * 10 / 1.15077945 + 0.5);
-          break;
-      }
-    }
-  }
+void read_airspeed () {
+  int16_t mph = read_sensor (ASP_V3);   // In third party I2C mode, the airspeed sensor returns mph
+
+  /*
+   * The is a little drift on OpenTX, that was discussed here:
+   * https://github.com/opentx/opentx/issues/1422
+   *
+   * Although, the value will be recored correctly, as so in Companion.
+   * Don't try to resolve the shown value on the transmitter if you want
+   * to rely on the logged values.
+   *
+   * real conversion          | value shown OpenTX 
+   * -------------------------|----------------------
+   * 1 mph = 1.15077945 knots | 23 / 20 = 1.15 (up to 2.0.5: 31 / 27 = 1.148148148)
+   * 1 kph = 1.852 knots      | 50 / 27 = 1.851851852
+   */
+  airspeed.set (FrskySPScale<16093440, 1852000>::round (mph));  // mph * 10 / 1.15077945 + 0.5, without float
 }
 
 /*
@@ -0,0 +1,72 @@
+/*
+ * One board, 3 buses: 2 Smart Port buses on the hardware UARTs of a Mega (each through an inverter), and a D port
+ * line on SoftwareSerial. FrskySPPump serves them in turn from loop(), and tells how long each bus may wait.
+ *
+ * Pinout (Mega 2560)
+ * ------------------
+ * Serial1 (18 TX, 19 RX) - Smart Port bus 1, inverter, line driver enabled by pin 2
+ * Serial2 (16 TX, 17 RX) - Smart Port bus 2, inverter, line driver enabled by pin 3
+ * 10 (RX), 11 (TX)       - D port line
+ *
+ * Remarks
+ * -------
+ * Only one SoftwareSerial can be used: it receives on one object at a time, and disables the interrupts while it sends
+ * or receives a byte. The D line sends in the background (FrskyD::async(), Timer2 with FrskyDTimer2.h), so it never
+ * holds the loop.
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#include <FrskySP.h>
+#include <FrskyD.h>
+#include <FrskyDTimer2.h>
+#include <SoftwareSerial.h>
+
+FrskySPSerial<HardwareSerial> port1 (Serial1, 2, true);   // the answers are heard back (receiver always on)
+FrskySPSerial<HardwareSerial> port2 (Serial2, 3, true);
+FrskySP bus1 (port1);
+FrskySP bus2 (port2);
+FrskyDPins<10, 11> line;
+FrskySPPump pump;
+
+FrskySPSlot rpm (FRSKY_SP_RPM);
+FrskySPSlot vfas (FRSKY_SP_VFAS);
+
+unsigned long last = 0;
+unsigned long report = 0;
+
+void setup () {
+  Serial.begin (115200);
+  port1.begin (FRSKY_SP_SPEED);
+  port2.begin (FRSKY_SP_SPEED);
+  line.async ();
+  bus1.attach (4, &rpm);               // physical ID 4 (0xE4)
+  bus2.attach (2, &vfas);              // physical ID 2 (0xA1)
+  pump.add (bus1);
+  pump.add (bus2);
+  pump.add (line);
+}
+
+void loop () {
+  pump.run ();
+
+  rpm.set (analogRead (A0) * 10);
+  vfas.set (FrskySPCodec<FRSKY_SP_VFAS>::encode<1000> (analogRead (A1) * 5000L / 1023));
+  if (millis () - last > 1000) {
+    line.sendData (FRSKY_D_TEMP1, analogRead (A2) / 10);
+    last = millis ();
+  }
+
+  if (millis () - report > 10000) {
+    report = millis ();
+    for (uint8_t i=0; i<pump.count (); i++) {
+      Serial.print ("bus ");
+      Serial.print (i);
+      Serial.print (": step max ");
+      Serial.print (pump.stepMax (i));
+      Serial.print (" us, wait max ");
+      Serial.print (pump.latency (i));
+      Serial.println (" us");
+    }
+  }
+}
@@ -6,7 +6,12 @@
  * - FrskySP library: https://github.com/jcheger/frsky-arduino
  * - FreqCount library: https://www.pjrc.com/teensy/td_libs_FreqCount.html
  * 
- * The RPM pin is 5 and cannot be changed (defined by the FreqCount library). The RPMs are refreshed once per second.
+ * The RPM pin is 5 and cannot be changed (defined by the FreqCount library). The gate is chosen by FrskySPFreq after
+ * each count: short (down to 8 ms) at high RPM, where a few ms hold enough pulses, and 4 ms ticks at low RPM, where
+ * the RPM is measured by period (the time between the ticks with pulses). Below 600 rpm (one pulse per 100 ms), it
+ * reads 0: the brushless sensor triggers 1~10 pulses per second when the motor is stopped.
+ *
+ * The value is pre-encoded in a slot after each gate, and sent as is at the next poll of the physical ID 4 (0xE4).
  *
  * See the the images in the example folder to see the pinout.
  *
@@ -36,50 +41,45 @@
 
 FrskySP FrskySP (10, 11);
 
-/*
- * This is the ratio between the sensor and the final stage.
- * - if the sensor is measuring the final stage, the ratio is oviously 1.0
- * - if the ratio is an integer, you may cheat by declaring the ratio as the number of blades in OpenTX (up to 102)
- * - if the ratio is a float (reducer, helicopter), you will have to modify this value
- */
-float rpm_ratio = 1.0;
+FrskySPFreq rpm;
+FrskySPSlot rpm_slot (FRSKY_SP_RPM);
 
 void setup () {
   #if DEBUG
   Serial.begin (115200);
   Serial.println ("FrskySP rpm sensor freqcount");
   #endif
-  FreqCount.begin(1000);
-}
-
-void loop () {
-  static unsigned int i = 0;
-
-  static unsigned long rpm_freq = 0;
-  uint32_t             rpm_send = 0;
 
-  while (FrskySP.available ()) {
+  /*
+   * This is the ratio between the sensor and the final stage: pulses per revolution, as a fraction.
+   * - if the sensor is measuring the final stage, the ratio is oviously 1
+   * - if the ratio is an integer, you may cheat by declaring the ratio as the number of blades in OpenTX (up to 102)
+   * - else (reducer, helicopter), give it as pulses per revolutions, ex. 8.5:1 = rpm.ratio (17, 2)
+   */
+  rpm.ratio (1);
 
-    if (FrskySP.read () == 0x7E) {
-
-      while (!FrskySP.available ());  // wait for the next byte
-
-      switch (FrskySP.read ()) {
+  FrskySP.attach (4, &rpm_slot);                    // 0xE4
+  FreqCount.begin (rpm.gate ());
+}
 
-        case 0xE4:
-          rpm_freq = FreqCount.read();
-          // The brushless sensor triggers 1~10 pulses per second when no RPM is detected. Erase them.
-          rpm_send = (rpm_freq > 10) ? rpm_freq * 60.0 / rpm_ratio : 0;
-          #if DEBUG
-          Serial.print ("rpm_freq: ");
-          Serial.print (rpm_freq);
-          Serial.print (", rpm_send: ");
-          Serial.println (rpm_send);
-          #endif
-          FrskySP.sendData (FRSKY_SP_RPM, rpm_send);
-          break;
-      }
+void loop () {
+  if (FreqCount.available ()) {
+    if (rpm.count (FreqCount.read ())) {            // new gate
+      FreqCount.end ();
+      FreqCount.begin (rpm.gate ());
     }
+    rpm_slot.set (rpm.rpm ());
+    #if DEBUG
+    static unsigned long shown = 0;
+    if (millis () - shown >= 1000) {                // the debug port is too slow for every gate
+      shown = millis ();
+      Serial.print ("gate: ");
+      Serial.print (rpm.gate ());
+      Serial.print (", rpm: ");
+      Serial.println (rpm.rpm ());
+    }
+    #endif
   }
-}
 
+  FrskySP.update ();
+}
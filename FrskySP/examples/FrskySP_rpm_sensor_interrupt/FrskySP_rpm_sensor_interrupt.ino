@@ -1,7 +1,12 @@
 /*
  * RPM sensor for Frsky Smart Port protocol.
  * 
- * The RPM pin is 2 and cannot be changed (interrupt 0). The RPMs is refreshed once per second.
+ * The RPM pin is 2 and cannot be changed (interrupt 0). The interrupt only timestamps the falling edges: the RPM is
+ * computed from the periods between the last 8 edges (see FrskySPRpm), and refreshed at each edge - every 100 ms at
+ * 600 rpm, much faster above. Below 600 rpm (one edge per 100 ms), it reads 0: the brushless sensor triggers 1~10
+ * pulses per second when the motor is stopped.
+ *
+ * The value is pre-encoded in a slot, sent as is when the physical ID 4 (0xE4) is polled.
  *
  * Requirements
  * ------------
@@ -34,67 +39,39 @@
 
 FrskySP FrskySP (10, 11);
 
-unsigned long rpm_count = 0;
-unsigned long rpm_micros  = micros ();
-
-/*
- * This is the ratio between the sensor and the final stage.
- * - if the sensor is measuring the final stage, the ratio is oviously 1.0
- * - if the ratio is an integer, you may cheat by declaring the ratio as the number of blades in OpenTX (up to 102)
- * - if the ratio is a float (reducer, helicopter), you will have to modify this value
- */
-float rpm_ratio = 1.0;
+FrskySPRpm  rpm;
+FrskySPSlot rpm_slot (FRSKY_SP_RPM);
 
 void setup () {
   #if DEBUG
   Serial.begin (115200);
   Serial.println ("FrskySP rpm sensor interrupt");
   #endif
-  
+
+  /*
+   * This is the ratio between the sensor and the final stage: edges per revolution, as a fraction.
+   * - if the sensor is measuring the final stage, the ratio is oviously 1
+   * - if the ratio is an integer, you may cheat by declaring the ratio as the number of blades in OpenTX (up to 102)
+   * - else (reducer, helicopter), give it as pulses per revolutions, ex. 8.5:1 = rpm.ratio (17, 2)
+   */
+  rpm.ratio (1);
+
+  FrskySP.attach (4, &rpm_slot);                    // 0xE4
   attachInterrupt (0, rpmISR, FALLING);
 }
 
 void loop () {
-  static unsigned int i = 0;
-
-  static float    rpm_freq   = 0;
-  float           rpm_period = 0;
-  static uint32_t rpm_send   = 0;
-
-  rpm_period = (micros () - rpm_micros) / 1000000;
-  if (rpm_period >= 1) {
-    rpm_freq = rpm_count / rpm_period;
-    // The brushless sensor triggers 1~10 pulses per second when no RPM is detected. Erase them.
-    rpm_send = (rpm_freq > 10) ? rpm_freq * 60 / rpm_ratio : 0;
-    rpm_micros  = micros ();
-    rpm_count = 0;
+  if (rpm.update ()) {
+    rpm_slot.set (rpm.rpm ());
+    #if DEBUG
+    Serial.print ("rpm: ");
+    Serial.println (rpm.rpm ());
+    #endif
   }
 
-  while (FrskySP.available ()) {
-
-    if (FrskySP.read () == 0x7E) {
-
-      while (!FrskySP.available ());  // wait for the next byte
-
-      switch (FrskySP.read ()) {
-
-        case 0xE4:
-          #if DEBUG
-          Serial.print ("rpm_freq: ");
-          Serial.print (rpm_freq);
-          Serial.print (", rpm_out: ");
-          Serial.print (rpm_send);
-          Serial.print (", rpm_send: ");
-          Serial.println (rpm_send);
-          #endif
-          
-          FrskySP.sendData (FRSKY_SP_RPM, rpm_send);
-          break;
-      }
-    }
-  }
+  FrskySP.update ();
 }
 
 void rpmISR () {
-  rpm_count++;
+  rpm.edge ();
 }
@@ -3,7 +3,18 @@
  * ------------
  * - FrskySP library - https://github.com/jcheger/frsky-arduino
  * - Recent version of Arduino's IDE (ex. 1.6.1), else SoftwareSerial will fail at 57600 bds.
- * 
+ *
+ * Each value is pre-encoded in a slot when it changes, and the slots are attached to their physical ID in setup ().
+ * loop () never waits for the receiver: update () only handles the bytes already received, and sends the slot of the
+ * polled physical ID.
+ *
+ * Several values within the same physical ID - only one can be sent per cycle. The slot sent is the most overdue one:
+ * values that did not change are skipped (until they reach their maximum age), the others are weighted by their
+ * priority.
+ *
+ * No float is used: the values are given as integers (mV, cm, km/h), and converted with FrskySP::lipoCellMv () and
+ * FrskySPScale.
+ *
  * origin: https://github.com/jcheger/frsky-arduino
  * author: Jean-Christophe Heger <jcheger@ordinoscope.net>
  */
@@ -13,130 +24,92 @@
 
 FrskySP FrskySP (10, 11);
 
+int32_t alt = 10000;  // [cm] for demonstration only - altitude must be over 0 to be set as a reference in OpenTX
+
+// Physical ID 1 - FLVSS Lipo sensor (can be sent with one or two cell voltages)
+FrskySPSlot cells[8] = {FRSKY_SP_CELLS, FRSKY_SP_CELLS, FRSKY_SP_CELLS, FRSKY_SP_CELLS,
+                        FRSKY_SP_CELLS, FRSKY_SP_CELLS, FRSKY_SP_CELLS, FRSKY_SP_CELLS};
+// Physical ID 2 - FAS-40S current sensor
+FrskySPSlot curr (FRSKY_SP_CURR);
+FrskySPSlot vfas (FRSKY_SP_VFAS);
+// Physical ID 3 - GPS / altimeter (normal precision)
+FrskySPSlot gpsAlt (FRSKY_SP_GPS_ALT);
+FrskySPSlot gpsSpeed (FRSKY_SP_GPS_SPEED);
+FrskySPSlot varioAlt (FRSKY_SP_ALT);
+// Physical ID 4 - RPM
+FrskySPSlot rpm (FRSKY_SP_RPM);
+// Physical ID 5 - SP2UART(Host)
+FrskySPSlot adc2 (FRSKY_SP_ADC2_ID);
+FrskySPSlot a3 (FRSKY_SP_A3);
+FrskySPSlot a4 (FRSKY_SP_A4);
+// Physical ID 23
+FrskySPSlot accX (FRSKY_SP_ACCX);
+FrskySPSlot accY (FRSKY_SP_ACCY);
+FrskySPSlot accZ (FRSKY_SP_ACCZ);
+// Physical ID 24
+FrskySPSlot fuel (FRSKY_SP_FUEL);
+// Physical ID 26
+FrskySPSlot t1 (FRSKY_SP_T1);
+FrskySPSlot t2 (FRSKY_SP_T2);
+
 void setup () {
+  int i;
+
   FrskySP.ledSet (13);
+
+  // physical IDs (0~27) - the poll byte is given as comment
+  for (i = 0; i < 8; i++) FrskySP.attach (1, &cells[i]);   // 0xA1
+  FrskySP.attach (2,  &curr);                               // 0x22
+  FrskySP.attach (2,  &vfas);
+  gpsAlt.schedule (2, 200);                                 // altitudes are refreshed more often
+  varioAlt.schedule (2, 200);
+  FrskySP.attach (3,  &gpsAlt);                             // 0x83
+  FrskySP.attach (3,  &gpsSpeed);
+  FrskySP.attach (3,  &varioAlt);
+  FrskySP.attach (4,  &rpm);                                // 0xE4
+  FrskySP.attach (5,  &adc2);                               // 0x45
+  FrskySP.attach (5,  &a3);
+  FrskySP.attach (5,  &a4);
+  FrskySP.attach (23, &accX);                               // 0xB7
+  FrskySP.attach (23, &accY);
+  FrskySP.attach (23, &accZ);
+  FrskySP.attach (24, &fuel);                               // 0x98
+  FrskySP.attach (26, &t1);                                 // 0xBA
+  FrskySP.attach (26, &t2);
+
+  // works better by sending only on cell voltage for a large amount of cells
+  cells[0].set (FrskySP.lipoCellMv (0, 1010, 1020));
+  cells[1].set (FrskySP.lipoCellMv (2, 1030, 1040));
+  cells[2].set (FrskySP.lipoCellMv (4, 1050, 1060));
+  cells[3].set (FrskySP.lipoCellMv (6, 1070, 1080));
+  cells[4].set (FrskySP.lipoCellMv (8, 1090));
+  cells[5].set (FrskySP.lipoCellMv (9, 1100));
+  cells[6].set (FrskySP.lipoCellMv (10, 1110));
+  cells[7].set (FrskySP.lipoCellMv (11, 1120));
+  curr.set (11.5 * 10);
+  vfas.set (22.2 * 100);
+  gpsSpeed.set (FrskySPScale<1000000, 1852, 3000>::encode (100));   // 100 km/h, in knots * 1000
+  rpm.set (11111);
+  adc2.set (1);
+  a3.set (10);
+  a4.set (100);
+  accX.set ( 1.11 * 100);
+  accY.set (-2.22 * 100);
+  accZ.set ( 3.33 * 100);
+  fuel.set (41);
+  t1.set (28);
+  t2.set (18);
 }
 
 void loop () {
-  static unsigned int i = 0;  // increment used when several values must be sent within the same physical ID - only one per cycle
-  static float alt = 100.0;   // for demonstration only - altitude must be over 0 to be set as a reference in OpenTX
-  
-  while (FrskySP.available ()) {
-    
-    if (FrskySP.read () == 0x7E) {
-      while (!FrskySP.available ());  // wait for the next byte
-      switch (FrskySP.read ()) {
+  static unsigned long alt_millis = 0;
 
-        case 0x00:  // Physical ID 1 - Vario2 (altimeter high precision)
-          break;
-          
-        case 0xA1:  // Physical ID 2 - FLVSS Lipo sensor (can be sent with one or two cell voltages)
-          // works better by sending only on cell voltage for a large amount of cells
-          if (i % 8 == 0) FrskySP.sendData (FRSKY_SP_CELLS, FrskySP.lipoCell (0, 1.01, 1.02));
-          if (i % 8 == 1) FrskySP.sendData (FRSKY_SP_CELLS, FrskySP.lipoCell (2, 1.03, 1.04));
-          if (i % 8 == 2) FrskySP.sendData (FRSKY_SP_CELLS, FrskySP.lipoCell (4, 1.05, 1.06));
-          if (i % 8 == 3) FrskySP.sendData (FRSKY_SP_CELLS, FrskySP.lipoCell (6, 1.07, 1.08));
-          if (i % 8 == 4) FrskySP.sendData (FRSKY_SP_CELLS, FrskySP.lipoCell (8, 1.09));
-          if (i % 8 == 5) FrskySP.sendData (FRSKY_SP_CELLS, FrskySP.lipoCell (9, 1.10));
-          if (i % 8 == 6) FrskySP.sendData (FRSKY_SP_CELLS, FrskySP.lipoCell (10, 1.11));
-          if (i % 8 == 7) FrskySP.sendData (FRSKY_SP_CELLS, FrskySP.lipoCell (11, 1.12));
-          break;
-          
-        case 0x22:  // Physical ID 3 - FAS-40S current sensor
-          if (i % 2 == 0) FrskySP.sendData (FRSKY_SP_CURR, 11.5 * 10);
-          if (i % 2 == 1) FrskySP.sendData (FRSKY_SP_VFAS, 22.2 * 100);
-          break;
-          
-        case 0x83:  // Physical ID 4 - GPS / altimeter (normal precision)
-          if (i % 3 == 0) FrskySP.sendData (FRSKY_SP_GPS_ALT, alt * 100);
-          if (i % 3 == 1) FrskySP.sendData (FRSKY_SP_GPS_SPEED, (float) 100 / 1.852 * 1000);
-          //if (i % 3 == 2) FrskySP.sendData (FRSKY_SP_ALT, alt * 100);
-          alt += 0.1;
-          break;
-          
-        case 0xE4:  // Physical ID 5 - RPM
-          FrskySP.sendData (FRSKY_SP_RPM, 11111);
-          break;
-          
-        case 0x45:  // Physical ID 6 - SP2UART(Host)
-          if (i % 3 == 0) FrskySP.sendData (FRSKY_SP_ADC2_ID, 1);
-          if (i % 3 == 1) FrskySP.sendData (FRSKY_SP_A3,      10);
-          if (i % 3 == 2) FrskySP.sendData (FRSKY_SP_A4,      100);
-          break;
-          
-        case 0xC6:  // Physical ID 7 - SPUART(Remote)
-          break;
-          
-        case 0x67:  // Physical ID 8 - 
-          break;
-          
-        case 0x48:  // Physical ID 9 - 
-          break;
-          
-        case 0xE9:  // Physical ID 10 - 
-          break;
-          
-        case 0x6A:  // Physical ID 11 - 
-          break;
-          
-        case 0xCB:  // Physical ID 12 - 
-          break;
-          
-        case 0xAC:  // Physical ID 13 - 
-          break;
-          
-        case 0x0D:  // Physical ID 14 - 
-          break;
-          
-        case 0x8E:  // Physical ID 15 - 
-          break;
-          
-        case 0x2F:  // Physical ID 16 - 
-          break;
-          
-        case 0xD0:  // Physical ID 17 - 
-          break;
-          
-        case 0x71:  // Physical ID 18 - 
-          break;
-          
-        case 0xF2:  // Physical ID 19 - 
-          break;
-          
-        case 0x53:  // Physical ID 20 - 
-          break;
-          
-        case 0x34:  // Physical ID 21 - 
-          break;
-          
-        case 0x95:  // Physical ID 22 - 
-          break;
-          
-        case 0x16:  // Physical ID 23 - 
-          break;
-          
-        case 0xB7:  // Physical ID 24 - 
-          if (i % 3 == 0) FrskySP.sendData (FRSKY_SP_ACCX,  1.11 * 100);
-          if (i % 3 == 1) FrskySP.sendData (FRSKY_SP_ACCY, -2.22 * 100);
-          if (i % 3 == 2) FrskySP.sendData (FRSKY_SP_ACCZ,  3.33 * 100);
-          break;
-          
-        case 0x98:  // Physical ID 25 - 
-          FrskySP.sendData (FRSKY_SP_FUEL, 41);
-          break;
-          
-        case 0x39:  // Physical ID 26 - 
-          break;
-          
-        case 0xBA:  // Physical ID 27 - 
-          if (i % 2 == 0) FrskySP.sendData (FRSKY_SP_T1, 28);
-          if (i % 2 == 1) FrskySP.sendData (FRSKY_SP_T2, 18);
-          break;
-          
-        case 0x1B:  // Physical ID 28 - 
-          break;
-      }
-    }
+  if (millis () - alt_millis >= 100) {
+    alt_millis = millis ();
+    alt += 10;
+    gpsAlt.set (alt);
+    varioAlt.set (alt);
   }
-  i++;
+
+  FrskySP.update ();
 }
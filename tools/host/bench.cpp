@@ -0,0 +1,150 @@
+/*
+ * Micro-benchmarks of the FrskySP and FrskyD libraries, built on Linux against the Arduino stand-in (see shim/).
+ *
+ * Usage
+ * -----
+ * make bench && ./bench [filter]
+ *
+ * Every benchmark whose name contains [filter] is run (all when omitted). Each one is repeated until it runs for at
+ * least 200 ms, and reports the time per call and, for the calls that produce or consume packets, the packet rate.
+ * The figures are host figures: use them to compare two versions of the code, not to guess the AVR timing.
+ *
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#include <FrskySP.h>
+#include <FrskyD.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+static volatile uint32_t sink;              // results are stored here, so that nothing is optimized away
+static const char       *filter = NULL;
+
+/*
+ * Run f(i) in a loop, until the loop takes at least 200 ms, and report the figures.
+ * packets is the number of packets produced or consumed by one call (0 if it does not apply).
+ */
+template <typename F> static void bench (const char *name, unsigned int packets, F f) {
+    typedef std::chrono::steady_clock clock;
+    unsigned long n = 1024;
+    double        ns;
+
+    if (filter && !strstr (name, filter)) return;
+
+    for (;;) {
+        clock::time_point start = clock::now ();
+        for (unsigned long i = 0; i < n; i++) f (i);
+        ns = std::chrono::duration<double, std::nano> (clock::now () - start).count ();
+        if (ns >= 200e6) break;
+        n *= 2;
+    }
+
+    if (packets) printf ("%-32s %10.2f ns/op %14.0f packets/s\n", name, ns / n, packets * n * 1e9 / ns);
+    else         printf ("%-32s %10.2f ns/op\n", name, ns / n);
+}
+
+int main (int argc, char **argv) {
+    FrskySP sp (10, 11);
+    SoftwareSerial uart (12, 13, true);
+    FrskySPSerial<SoftwareSerial> line (uart, -1, false);
+    FrskySP spl (line);
+    FrskyD  d (8, 9);
+    FrskyD  dq (6, 7);
+    uint8_t packet[8] = {0x10, 0x00, 0x05, 0x67, 0x2b, 0x00, 0x00, 0x00};
+    byte    buffer[2] = {0x57, 0x04};
+    static uint8_t packets[1024 * 8];
+    static uint8_t stream[1024 * 7];
+    size_t         streamLen = 0;
+    static uint8_t bus[1024 * 10];
+    FrskySPDecoder decoder;
+    FrskySPSlot slot (FRSKY_SP_RPM);
+    FrskySPRpm  rpm;
+    FrskySPFreq freq;
+    FrskySPSlot gps[4] = {FRSKY_SP_GPS_ALT, FRSKY_SP_GPS_SPEED, FRSKY_SP_GPS_COURSE, FRSKY_SP_ALT};
+    FrskyDFrame<22> frame (FRSKY_D_FRAME1_PERIOD);
+    FrskyDPairs     pairs;
+
+    if (argc > 1) filter = argv[1];
+    dq.async ();
+    line.begin (FRSKY_SP_SPEED);
+    packet[7] = sp.CRC (packet);
+    slot.set (11111);
+    rpm.timeout (10000);
+    for (int i = 0; i < FRSKY_SP_RPM_EDGES; i++) rpm.edge (micros () - (FRSKY_SP_RPM_EDGES - i) * 1000);
+    for (int i = 0; i < 4; i++) {
+        gps[i].schedule (i + 1, 200 * (i + 1));
+        gps[i].set (i);
+        sp.attach (3, &gps[i]);
+    }
+    for (int i = 0; i < 1024; i++) {
+        memcpy (&packets[i * 8], packet, 8);
+        packets[i * 8 + 3] = i;
+        packets[i * 8 + 7] = sp.CRC (&packets[i * 8]) + (i % 3 == 0);
+    }
+
+    for (int i = 0; i < 1024; i++) {
+        bus[i * 10]     = FRSKY_SP_POLL;
+        bus[i * 10 + 1] = FrskySPCrc::physicalId (i % FRSKY_SP_PHYSICAL_IDS);
+        memcpy (&bus[i * 10 + 2], &packets[i * 8], 8);
+    }
+
+    for (int i = 0; i < 12; i++) frame.setCellVolt (i, 3.7f + i * 0.01f);
+    for (int i = 0; i < 10; i++) frame.set (FRSKY_D_ACCX + i, i * 0x5D);
+
+    for (int i = 0; i < 1024; i++) {
+        int b;
+        d.sendData (FRSKY_D_ACCX + (i & 3), i * 0x5D);
+        while ((b = d.mySerial->hostTxRead ()) >= 0) stream[streamLen++] = b;
+    }
+
+    printf ("FrskySP\n");
+    bench ("FrskySP::CRC",                1, [&] (unsigned long i) { packet[3] = i; sink += sp.CRC (packet); });
+    bench ("FrskySP::CRCcheck",           1, [&] (unsigned long i) { packet[3] = i; sink += sp.CRCcheck (packet); });
+    bench ("FrskySPCrc::update (8 bytes)", 1, [&] (unsigned long i) { FrskySPCrc crc; packet[3] = i; crc.update (packet, 8); sink += crc.valid (); });
+    bench ("FrskySPCrc::check (1024 pkts)", 1024, [&] (unsigned long i) { packets[3] = i; sink += FrskySPCrc::check (packets, 1024); });
+    bench ("FrskySP::feed (poll)",        0, [&] (unsigned long i) { sp.feed (FRSKY_SP_POLL); sink += sp.feed (FrskySPCrc::physicalId (i % FRSKY_SP_PHYSICAL_IDS)); });
+    bench ("FrskySPDecoder::feed (1024 pkts)", 1024, [&] (unsigned long i) { for (size_t j = 0; j < sizeof (bus); j++) sink += decoder.feed (bus[j]); });
+    bench ("FrskySPStuffing::stuff",      1, [&] (unsigned long i) { uint8_t p[FRSKY_SP_PACKET_MAX] = {0x10, 0x00, 0x0a}; p[3] = 0x7c + (i & 3); p[7] = i; sink += FrskySPStuffing::stuff (p, FrskySPStuffing::mask (p)); });
+    bench ("FrskySP::sendData",           1, [&] (unsigned long i) { sp.sendData (FRSKY_SP_RPM, i); });
+    bench ("FrskySPSlot::set",            0, [&] (unsigned long i) { slot.set (i); });
+    bench ("FrskySPRpm::update (8 edges)", 0, [&] (unsigned long i) { sink += rpm.update (); });
+    bench ("FrskySPFreq::count",          0, [&] (unsigned long i) { sink += freq.count (i & 3); });
+    bench ("FrskySP::send (slot)",        1, [&] (unsigned long i) { sp.send (slot); });
+    bench ("FrskySP::send (FrskySPSerial)", 1, [&] (unsigned long i) { spl.send (slot); });
+    bench ("FrskySP::feed (4 slots)",     1, [&] (unsigned long i) { gps[i & 3].set (i); sp.feed (FRSKY_SP_POLL); sp.feed (FrskySPCrc::physicalId (3)); });
+    bench ("FrskySP::lipoCell (1 cell)",  0, [&] (unsigned long i) { sink += sp.lipoCell (i & 0x07, 3.7f + (i & 0xff) * 0.001f); });
+    bench ("FrskySP::lipoCell (2 cells)", 0, [&] (unsigned long i) { sink += sp.lipoCell (i & 0x07, 3.7f + (i & 0xff) * 0.001f, 3.8f); });
+    bench ("FrskySP::lipoCellMv (2 cells)", 0, [&] (unsigned long i) { sink += sp.lipoCellMv (i & 0x07, 3700 + (i & 0xff), 3800); });
+    bench ("FrskySPScale (mph, float)",   0, [&] (unsigned long i) { sink += (int32_t) ((int16_t) i * 10 / 1.15077945f + 0.5f); });
+    bench ("FrskySPScale (mph)",          0, [&] (unsigned long i) { sink += FrskySPScale<16093440, 1852000>::round (i & 0x7fff); });
+    bench ("FrskySPSensors::lookup",      1, [&] (unsigned long i) { sink += FrskySPSensors::lookup (FrskySPSensors::table[i % FrskySPSensors::count].id)->scale; });
+    bench ("FrskySPCodec::encode (mV)",   0, [&] (unsigned long i) { sink += FrskySPCodec<FRSKY_SP_VFAS>::encode<1000> (i & 0xffff); });
+
+    printf ("\nFrskyD\n");
+    bench ("FrskyD::sendData",            1, [&] (unsigned long i) { d.sendData (FRSKY_D_RPM, i); });
+    bench ("FrskyD::sendFloat",           2, [&] (unsigned long i) { d.sendFloat (FRSKY_D_ALT_B, FRSKY_D_ALT_A, (i & 0xffff) * 0.01f); });
+    bench ("FrskyD::sendFixed",           2, [&] (unsigned long i) { d.sendFixed (FRSKY_D_ALT_B, FRSKY_D_ALT_A, i & 0xffff); });
+    bench ("FrskyD::sendCellMv",          1, [&] (unsigned long i) { d.sendCellMv (i & 0x0f, 3700 + (i & 0xff)); });
+    bench ("FrskyD::sendCellVolt",        1, [&] (unsigned long i) { d.sendCellVolt (i & 0x0f, 3.7f + (i & 0xff) * 0.001f); });
+    bench ("FrskyD::sendData (queued)",   1, [&] (unsigned long i) { dq.sendData (FRSKY_D_RPM, i); while (dq.txQueue->pop () >= 0); });
+    bench ("FrskyD::send (22 values)",   22, [&] (unsigned long i) { frame.set (FRSKY_D_ACCX, i); d.send (frame); });
+    bench ("FrskyD::feed (1024 pkts)", 1024, [&] (unsigned long i) { for (size_t j = 0; j < streamLen; j++) sink += d.feed (stream[j]); });
+    bench ("FrskyDPairs::feed (B + A)",   1, [&] (unsigned long i) { pairs.feed (FRSKY_D_GPS_LAT_B, i); sink += pairs.feed (FRSKY_D_GPS_LAT_A, i); });
+    bench ("FrskyDSensors::lookup",       1, [&] (unsigned long i) { const FrskyDSensor *s = FrskyDSensors::lookup (i & 0x3f); sink += s ? s->scale : 0; });
+    bench ("FrskyDPairs::value",          0, [&] (unsigned long i) { sink += pairs.value (FRSKY_D_GPS_LAT_B); });
+    bench ("FrskyD::calcFloat",           0, [&] (unsigned long i) { sink += d.calcFloat (i & 0x3ff, i & 0x3f); });
+    bench ("FrskyD::calcFixed",           0, [&] (unsigned long i) { sink += d.calcFixed (i & 0x3ff, i & 0x3f); });
+    bench ("FrskyD::decodeInt",           1, [&] (unsigned long i) { buffer[0] = i; sink += d.decodeInt (buffer); });
+    bench ("FrskyD::decode1Int",          1, [&] (unsigned long i) { buffer[0] = i; sink += d.decode1Int (buffer); });
+    bench ("FrskyD::decodeCellVolt",      1, [&] (unsigned long i) { buffer[1] = i; sink += d.decodeCellVolt (buffer); });
+    bench ("FrskyD::decodeCellVoltId",    1, [&] (unsigned long i) { buffer[0] = i; sink += d.decodeCellVoltId (buffer); });
+    bench ("FrskyD::decodeGpsLat",        2, [&] (unsigned long i) { sink += d.decodeGpsLat (4642, i & 0x1fff).length (); });
+    bench ("FrskyD::decodeGpsLong",       2, [&] (unsigned long i) { sink += d.decodeGpsLong (726, i & 0x1fff).length (); });
+    bench ("FrskyD::decodeGps",           2, [&] (unsigned long i) { sink += FrskyD::decodeGps (4642, i & 0x1fff, 'N').frac; });
+    bench ("FrskyD::formatGps",           0, [&] (unsigned long i) { char s[FRSKY_D_GPS_FORMAT_SIZE]; sink += FrskyD::formatGps (FrskyD::decodeGps (4642, i & 0x1fff, 'N'), s); });
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * Timestamped capture of a bus session (.fcap), and its memory-mapped replay - see capture.h.
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#include "capture.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+CaptureWriter *CaptureWriter::_active = NULL;
+
+/*
+ * Monotonic time [µs].
+ */
+static uint64_t _now () {
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+CaptureWriter::CaptureWriter (char protocol) : _protocol (protocol), _none (-1), _d (_none) {
+    this->_d.onValue (CaptureWriter::_onValue);
+}
+
+/*
+ * Create the file, and write the header. start is the Unix time of the first byte [µs] (0 if unknown).
+ */
+bool CaptureWriter::open (const char *path, uint32_t speed, uint64_t start) {
+    CaptureHeader header;
+
+    if ((this->_file = fopen (path, "wb")) == NULL) return false;
+    memset (&header, 0, sizeof (header));
+    memcpy (header.magic, "FCAP", 4);
+    header.version  = CAPTURE_VERSION;
+    header.protocol = this->_protocol;
+    header.speed    = speed;
+    header.start    = start;
+    return fwrite (&header, sizeof (header), 1, this->_file) == 1;
+}
+
+/*
+ * Record one byte. time is in µs, from any origin, and never goes back.
+ */
+void CaptureWriter::write (uint8_t b, uint64_t time) {
+    uint64_t delta;
+    uint32_t flags = 0;
+    uint8_t  event;
+
+    if (this->_records == 0) this->_first = this->_last = time;
+    for (delta = time - this->_last; delta >= CAPTURE_GAP; delta -= CAPTURE_GAP) this->_put ((uint32_t) CAPTURE_GAP << 10);
+    this->_last = time;
+
+    if (this->_protocol == 'D') {
+        flags = CAPTURE_TX;
+        CaptureWriter::_active = this;
+        this->_d.feed (b);                  // indexed by _onValue ()
+    }
+    else {
+        event = this->_sp.feed (b);
+        if (b == FRSKY_SP_POLL || event == FRSKY_SP_EVENT_BAD_ID) this->_answer = false;
+        else if (event == FRSKY_SP_EVENT_POLL) {
+            flags = CAPTURE_POLL;
+            this->_answer = true;
+        }
+        else if (this->_answer) flags = CAPTURE_TX;
+        if (event == FRSKY_SP_EVENT_PACKET) this->_entry (this->_sp.id (), this->_sp.value ());
+    }
+    this->_put (b | flags | (uint32_t) delta << 10);
+}
+
+/*
+ * Write the index and the trailer, and close the file.
+ */
+bool CaptureWriter::close () {
+    std::vector<uint32_t> order (this->_entries.size ());
+    std::vector<CaptureDir> dir;
+    CaptureTrailer trailer;
+    uint32_t i;
+    bool ok;
+
+    for (i = 0; i < order.size (); i++) order[i] = i;
+    std::stable_sort (order.begin (), order.end (), [this] (uint32_t a, uint32_t b) { return this->_ids[a] < this->_ids[b]; });
+    for (i = 0; i < order.size (); i++) {
+        if (dir.empty () || dir.back ().id != this->_ids[order[i]]) {
+            CaptureDir d = {this->_ids[order[i]], 0, 0, i};
+            dir.push_back (d);
+        }
+        dir.back ().count++;
+    }
+
+    memset (&trailer, 0, sizeof (trailer));
+    memcpy (trailer.magic, "FIDX", 4);
+    trailer.ids     = dir.size ();
+    trailer.entries = order.size ();
+    trailer.records = this->_records;
+    trailer.index   = sizeof (CaptureHeader) + this->_records * 4;
+
+    fwrite (dir.data (), sizeof (CaptureDir), dir.size (), this->_file);
+    for (i = 0; i < order.size (); i++) fwrite (&this->_entries[order[i]], sizeof (CaptureEntry), 1, this->_file);
+    fwrite (&trailer, sizeof (trailer), 1, this->_file);
+    ok = !ferror (this->_file);
+    return fclose (this->_file) == 0 && ok;
+}
+
+/*
+ * Index a packet, ended by the last record written.
+ */
+void CaptureWriter::_entry (uint16_t id, int32_t value) {
+    CaptureEntry e = {this->_last - this->_first, (uint32_t) this->_records, value};
+
+    this->_ids.push_back (id);
+    this->_entries.push_back (e);
+}
+
+/*
+ * FrskyD::onValue () handler.
+ */
+void CaptureWriter::_onValue (uint8_t id, int16_t val) {
+    CaptureWriter::_active->_entry (id, val);
+}
+
+void CaptureWriter::_put (uint32_t r) {
+    fwrite (&r, 4, 1, this->_file);
+    this->_records++;
+}
+
+CaptureReader::~CaptureReader () {
+    if (this->_map) munmap ((void *) this->_map, this->_size);
+}
+
+/*
+ * Map the file, and check its structure. Returns false if it is not a complete capture.
+ */
+bool CaptureReader::open (const char *path) {
+    struct stat st;
+    int fd;
+
+    if ((fd = ::open (path, O_RDONLY)) < 0) return false;
+    if (fstat (fd, &st) < 0 || (size_t) st.st_size < sizeof (CaptureHeader) + sizeof (CaptureTrailer)) {
+        ::close (fd);
+        return false;
+    }
+    this->_size = st.st_size;
+    this->_map  = (const uint8_t *) mmap (NULL, this->_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close (fd);
+    if (this->_map == MAP_FAILED) {
+        this->_map = NULL;
+        return false;
+    }
+
+    this->_header  = (const CaptureHeader *) this->_map;
+    this->_trailer = (const CaptureTrailer *) (this->_map + this->_size - sizeof (CaptureTrailer));
+    if (memcmp (this->_header->magic, "FCAP", 4) || this->_header->version != CAPTURE_VERSION) return false;
+    if (memcmp (this->_trailer->magic, "FIDX", 4)) return false;
+    if (this->_trailer->index != sizeof (CaptureHeader) + this->_trailer->records * 4) return false;
+    if (this->_trailer->index + (uint64_t) this->_trailer->ids * sizeof (CaptureDir)
+        + (uint64_t) this->_trailer->entries * sizeof (CaptureEntry) + sizeof (CaptureTrailer) != this->_size) return false;
+
+    madvise ((void *) this->_map, this->_size, MADV_SEQUENTIAL);
+    this->_records = (const uint32_t *) (this->_map + sizeof (CaptureHeader));
+    this->_dir     = (const CaptureDir *) (this->_map + this->_trailer->index);
+    this->_entries = (const CaptureEntry *) (this->_dir + this->_trailer->ids);
+    return true;
+}
+
+/*
+ * Packets of a logical ID, by a binary search in the directory. Returns NULL (and count 0) if there is none.
+ */
+const CaptureEntry *CaptureReader::find (uint16_t id, uint32_t *count) const {
+    const CaptureDir *end = this->_dir + this->_trailer->ids;
+    const CaptureDir *d = std::lower_bound (this->_dir, end, id, [] (const CaptureDir &a, uint16_t b) { return a.id < b; });
+
+    if (d == end || d->id != id) {
+        *count = 0;
+        return NULL;
+    }
+    *count = d->count;
+    return this->_entries + d->first;
+}
+
+/*
+ * Sleep until the replay time of a byte.
+ */
+void CaptureReader::_wait (uint64_t time, double speed) {
+    uint64_t target;
+    uint64_t now = _now ();
+
+    if (this->_origin == 0) this->_origin = now - (uint64_t) (time / speed);
+    target = this->_origin + (uint64_t) (time / speed);
+    if (target > now + 100) usleep (target - now);
+}
@@ -0,0 +1,155 @@
+/*
+ * Timestamped capture of a bus session (.fcap), and its memory-mapped replay.
+ *
+ * Format
+ * ------
+ * All fields are little endian.
+ *
+ * part      | size          | content
+ * --------- | ------------- | ------------------------------------------------------------------------
+ * header    | 24 bytes      | CaptureHeader
+ * records   | 4 bytes each  | one per byte of the bus: byte | flags << 8 | delta << 10
+ * directory | 12 bytes each | CaptureDir, one per logical ID, sorted by ID
+ * entries   | 16 bytes each | CaptureEntry, one per packet, grouped by ID (directory order), in time order
+ * trailer   | 32 bytes      | CaptureTrailer
+ *
+ * A record holds the byte, the direction (CAPTURE_TX: sent by a sensor, not by the receiver), the poll marker
+ * (CAPTURE_POLL: physical ID byte of a valid poll) and the time since the previous record [µs] on 22 bits. A longer
+ * gap is written as gap records (delta CAPTURE_GAP, no byte) first.
+ *
+ * The index gives every packet of a logical ID (time, record, value) without reading the records: see
+ * CaptureReader::find().
+ *
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#ifndef FRSKY_HOST_CAPTURE_H
+#define FRSKY_HOST_CAPTURE_H
+
+#include <FrskySP.h>
+#include <FrskyD.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#define CAPTURE_VERSION  1
+#define CAPTURE_TX       0x100              //!<record flag: byte sent by a sensor (answer, D packet)
+#define CAPTURE_POLL     0x200              //!<record flag: physical ID byte of a valid poll (SP)
+#define CAPTURE_GAP      0x3fffff           //!<record delta: gap record, no byte
+
+struct CaptureHeader {
+    char     magic[4];                      //!<"FCAP"
+    uint8_t  version;                       //!<CAPTURE_VERSION
+    uint8_t  protocol;                      //!<'S' (Smart Port) or 'D'
+    uint16_t reserved;
+    uint32_t speed;                         //!<line speed [bds]
+    uint32_t reserved2;
+    uint64_t start;                         //!<time of the first record (Unix time [µs], 0 if unknown)
+};
+
+struct CaptureDir {
+    uint16_t id;                            //!<logical ID (SP), sensor ID (D)
+    uint16_t reserved;
+    uint32_t count;                         //!<number of entries
+    uint32_t first;                         //!<index of the first entry
+};
+
+struct CaptureEntry {
+    uint64_t time;                          //!<time since the first record [µs]
+    uint32_t record;                        //!<record of the last byte of the packet
+    int32_t  value;                         //!<value (D: signed 16 bits)
+};
+
+struct CaptureTrailer {
+    char     magic[4];                      //!<"FIDX"
+    uint32_t ids;                           //!<number of CaptureDir
+    uint32_t entries;                       //!<number of CaptureEntry
+    uint32_t reserved;
+    uint64_t records;                       //!<number of records
+    uint64_t index;                         //!<file offset of the first CaptureDir
+};
+
+/*
+ * Writes a capture: give it every byte of the bus with its time, it infers the direction and the poll markers, and
+ * indexes the packets with the FrskySP / FrskyD decoders.
+ */
+class CaptureWriter {
+    public:
+        CaptureWriter (char protocol);
+
+        bool open (const char *path, uint32_t speed, uint64_t start);
+        void write (uint8_t b, uint64_t time);
+        bool close ();
+
+    private:
+        static void _onValue (uint8_t id, int16_t val);
+
+        void _entry (uint16_t id, int32_t value);
+        void _put (uint32_t r);
+
+        FILE                     *_file = NULL;
+        char                      _protocol;
+        uint64_t                  _records = 0;
+        uint64_t                  _first = 0;                       //!<time of the first record [µs]
+        uint64_t                  _last = 0;                        //!<time of the last record [µs]
+        bool                      _answer = false;                  //!<SP: the bytes are an answer (after a valid poll)
+        FrskySPDecoder            _sp;
+        FrskyDTermios             _none;                            //!<FrskyD needs a transport, never opened
+        class FrskyD              _d;
+        std::vector<uint16_t>     _ids;                             //!<ID of each entry
+        std::vector<CaptureEntry> _entries;
+
+        static CaptureWriter     *_active;                          //!<writer fed to the FrskyD handler
+};
+
+/*
+ * Maps a capture in memory: the records and the index are read in place.
+ */
+class CaptureReader {
+    public:
+        ~CaptureReader ();
+
+        bool                  open (const char *path);
+        const CaptureHeader  &header () const   { return *this->_header; }
+        const CaptureTrailer &trailer () const  { return *this->_trailer; }
+        const CaptureDir     *dir () const      { return this->_dir; }
+        const CaptureEntry   *find (uint16_t id, uint32_t *count) const;
+        uint64_t              records () const  { return this->_trailer->records; }
+
+        /*
+         * Call f (byte, flags, time) for each byte, in order. With speed > 0, the bytes are given in real time (speed
+         * 2: twice as fast), else as fast as possible.
+         */
+        template <typename F> void replay (F f, double speed = 0);
+
+    private:
+        void                 _wait (uint64_t time, double speed);
+
+        const uint8_t        *_map = NULL;
+        size_t                _size = 0;
+        const CaptureHeader  *_header = NULL;
+        const uint32_t       *_records = NULL;
+        const CaptureDir     *_dir = NULL;
+        const CaptureEntry   *_entries = NULL;
+        const CaptureTrailer *_trailer = NULL;
+        uint64_t              _origin = 0;                          //!<monotonic time of the replay start [µs]
+};
+
+template <typename F> void CaptureReader::replay (F f, double speed) {
+    uint64_t time = 0;
+    uint64_t i;
+    uint32_t r;
+
+    this->_origin = 0;
+    for (i = 0; i < this->_trailer->records; i++) {
+        r = this->_records[i];
+        time += r >> 10;
+        if ((r >> 10) == CAPTURE_GAP) continue;
+        if (speed > 0) this->_wait (time, speed);
+        f ((uint8_t) r, (uint16_t) (r & 0x300), time);
+    }
+}
+
+#endif
@@ -0,0 +1,315 @@
+/*
+ * Streaming decoder of raw Smart Port and D bus bytes, built on Linux with the FrskySP and FrskyD codecs.
+ *
+ * Usage
+ * -----
+ * make decode && ./decode [-p sp|d] [-f json|csv|bin] [-a] [-o output] [input] (or ./decode -C)
+ *
+ * -p  protocol (sp by default)
+ * -f  output format: JSON lines (default), CSV with a header line, or binary records
+ * -a  also output the polls (SP)
+ * -o  output file (stdout by default)
+ * -C  check only: GPS coordinates out of range fit in FRSKY_D_GPS_FORMAT_SIZE bytes, and a frame refused by a full
+ *     async() queue is counted as an overflow, not as sent (exit status 1 if not)
+ *
+ * The input is a tty (set raw, at the speed of the protocol), a pty, a fifo, a file, or stdin ("-" or omitted). It is
+ * read in blocks, and decoded as a stream: SP answers are unstuffed and their CRC checked (see FrskySPDecoder), D
+ * packets are unstuffed (see FrskyD::feed()). A live input is read until interrupted, and the output is flushed after
+ * each block. A summary is written to stderr at the end.
+ *
+ * Records
+ * -------
+ * field  | JSON / CSV                  | binary (20 bytes, little endian)
+ * ------ | --------------------------- | --------------------------------
+ * offset | offset of the last byte     | uint64
+ * event  | see FRSKY_SP_EVENT_*        | uint8 (D: FRSKY_SP_EVENT_PACKET)
+ * phys   | physical ID polled (SP)     | uint8 (0xff: none)
+ * type   | packet type (SP)            | uint8
+ * proto  | "sp" or "d"                 | uint8 ('S' or 'D')
+ * id     | logical ID (SP), ID (D)     | uint16
+ * crc    | CRC byte (SP)               | uint8, then 1 reserved byte
+ * value  | value (D: signed 16 bits)   | int32
+ *
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#include <FrskySP.h>
+#include <FrskyD.h>
+
+#include <chrono>
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum Format { JSON, CSV, BIN };
+
+static const char *events[] = {"none", "poll", "packet", "empty", "bad_crc", "short", "long", "bad_id"};
+
+static FILE          *out;
+static Format         format = JSON;
+static char           obuf[1 << 16];        // records are formatted here, and written when nearly full
+static size_t         olen = 0;
+static unsigned long  counts[8];            // records per event
+static uint64_t       offset = 0;           // offset of the byte being decoded
+
+/*
+ * Write the formatted records.
+ */
+static void flush () {
+    if (olen) fwrite (obuf, 1, olen, out);
+    olen = 0;
+}
+
+/*
+ * Append a decimal number (snprintf is too slow for millions of records).
+ */
+static char *put (char *p, uint64_t v) {
+    char  tmp[20];
+    char *t = tmp;
+
+    do { *t++ = '0' + v % 10; v /= 10; } while (v);
+    while (t > tmp) *p++ = *--t;
+    return p;
+}
+
+static char *put (char *p, const char *s) {
+    while (*s) *p++ = *s++;
+    return p;
+}
+
+static char *putSigned (char *p, int32_t v) {
+    if (v < 0) *p++ = '-';
+    return put (p, v < 0 ? -(int64_t) v : v);
+}
+
+/*
+ * Output one record.
+ */
+static void record (uint8_t event, char proto, int8_t phys, uint8_t type, uint16_t id, uint8_t crc, int32_t value) {
+    char *p;
+    int   i;
+
+    counts[event]++;
+    if (olen > sizeof (obuf) - 160) flush ();
+    p = &obuf[olen];
+
+    if (format == BIN) {
+        for (i=0; i<8; i++) *p++ = offset >> (i * 8);
+        *p++ = event;
+        *p++ = phys < 0 ? 0xff : phys;
+        *p++ = type;
+        *p++ = proto == 's' ? 'S' : 'D';
+        *p++ = id;
+        *p++ = id >> 8;
+        *p++ = crc;
+        *p++ = 0;
+        for (i=0; i<4; i++) *p++ = (uint32_t) value >> (i * 8);
+    }
+    else if (format == CSV) {
+        p = put (p, offset);               *p++ = ',';
+        p = put (p, events[event]);        *p++ = ',';
+        if (phys >= 0) p = put (p, phys);
+        *p++ = ',';
+        p = put (p, type);                 *p++ = ',';
+        p = put (p, proto == 's' ? "sp" : "d"); *p++ = ',';
+        p = put (p, id);                   *p++ = ',';
+        p = put (p, crc);                  *p++ = ',';
+        p = putSigned (p, value);          *p++ = '\n';
+    }
+    else {
+        p = put (p, "{\"offset\":");     p = put (p, offset);
+        p = put (p, ",\"event\":\"");    p = put (p, events[event]);
+        p = put (p, "\",\"phys\":");
+        if (phys >= 0) p = put (p, phys);
+        else           p = put (p, "null");
+        p = put (p, ",\"type\":");       p = put (p, type);
+        p = put (p, ",\"proto\":\"");    p = put (p, proto == 's' ? "sp" : "d");
+        p = put (p, "\",\"id\":");       p = put (p, id);
+        p = put (p, ",\"crc\":");        p = put (p, crc);
+        p = put (p, ",\"value\":");      p = putSigned (p, value);
+        p = put (p, "}\n");
+    }
+    olen = p - obuf;
+}
+
+/*
+ * FrskyD::onValue() handler.
+ */
+static void onValue (uint8_t id, int16_t val) {
+    record (FRSKY_SP_EVENT_PACKET, 'd', -1, 0, id, 0, val);
+}
+
+static void usage () {
+    fprintf (stderr, "usage: decode [-p sp|d] [-f json|csv|bin] [-a] [-o output] [input]\n"
+                     "       decode -C\n");
+    exit (2);
+}
+
+/*
+ * Format gps in a buffer of exactly FRSKY_D_GPS_FORMAT_SIZE bytes, followed by a guard: true if the text is the one
+ * expected and the guard is untouched.
+ */
+static bool checkGpsFormat (const FrskyDGps &gps, const char *expected) {
+    struct {
+        char buffer[FRSKY_D_GPS_FORMAT_SIZE];
+        char guard[8];
+    } s;
+    uint8_t len;
+    bool    ok;
+
+    memset (s.guard, 0x55, sizeof (s.guard));
+    len = FrskyD::formatGps (gps, s.buffer);
+    ok  = len < FRSKY_D_GPS_FORMAT_SIZE && !strcmp (s.buffer, expected);
+    for (size_t i=0; i<sizeof (s.guard); i++) ok = ok && s.guard[i] == 0x55;
+    printf ("%-24s -> \"%.*s\" (%u bytes): %s\n", expected, FRSKY_D_GPS_FORMAT_SIZE, s.buffer, len + 1,
+            ok ? "ok" : "FAILED");
+    return ok;
+}
+
+/*
+ * -C: GPS values out of range, as anything can come from the bus, are clamped by decodeGps(), and the worst a
+ * FrskyDGps filled by hand can give still fits in FRSKY_D_GPS_FORMAT_SIZE bytes.
+ */
+static int checkGps () {
+    FrskyDGps worst = {255, 255, 65535, 'W'};
+    bool      ok = true;
+
+    ok = checkGpsFormat (FrskyD::decodeGps (25599, 65535, 'W'), "180d 0m 0.0000s W") && ok;
+    ok = checkGpsFormat (FrskyD::decodeGps (-17999, 65535, 'S'), "179d 59m 59.9940s S") && ok;
+    ok = checkGpsFormat (FrskyD::decodeGps (4642, 8730, 'N'), "46d 42m 52.3800s N") && ok;
+    ok = checkGpsFormat (worst, "255d 255m 393.2100s W") && ok;
+    printf ("gps format: %s\n", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+/*
+ * -C: a frame sent again and again to a full async() queue is refused each time: sent stays, overflows grows. Then,
+ * with update() draining the queue, the rest of the frame goes.
+ */
+static int checkQueue () {
+    class FrskyD    d (10, 11);
+    FrskyDFrame<12> frame (FRSKY_D_FRAME1_PERIOD);
+    FrskyDStats     full;
+    uint8_t         i;
+    int             tries = 0;
+    bool            ok;
+
+    d.async ();
+    for (i=0; i<12; i++) frame.set (i + 1, 0x1234);                     // IDs 1~12, 4 bytes each, never stuffed
+    while (d.send (frame) && ++tries < 10) ;                            // until the queue is full
+    full = d.stats ();
+    for (i=0; i<3; i++) d.send (frame);
+    ok = tries < 10 && d.stats ().sent == full.sent && d.stats ().overflows == full.overflows + 3;
+    printf ("full queue: %s (sent %u -> %u, overflows %u -> %u)\n", ok ? "ok" : "FAILED", full.sent, d.stats ().sent,
+            full.overflows, d.stats ().overflows);
+
+    for (tries=0; tries<1000 && !d.send (frame); tries++) d.update ();
+    ok = tries < 1000 && ok;
+    printf ("queue drained: %s\n", tries < 1000 ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+int main (int argc, char **argv) {
+    typedef std::chrono::steady_clock clock;
+    const char    *input = "-";
+    bool           sp = true;
+    bool           polls = false;
+    bool           live;
+    int            opt, fd;
+    uint8_t        buf[1 << 16];
+    ssize_t        n, i;
+    struct stat    st;
+    FrskySPDecoder spDecoder;
+    uint8_t        event;
+
+    out = stdout;
+    while ((opt = getopt (argc, argv, "p:f:ao:C")) != -1) {
+        switch (opt) {
+            case 'p':
+                if      (!strcmp (optarg, "sp")) sp = true;
+                else if (!strcmp (optarg, "d"))  sp = false;
+                else usage ();
+                break;
+            case 'f':
+                if      (!strcmp (optarg, "json")) format = JSON;
+                else if (!strcmp (optarg, "csv"))  format = CSV;
+                else if (!strcmp (optarg, "bin"))  format = BIN;
+                else usage ();
+                break;
+            case 'a':
+                polls = true;
+                break;
+            case 'o':
+                if ((out = fopen (optarg, "w")) == NULL) {
+                    perror (optarg);
+                    return 1;
+                }
+                break;
+            case 'C':
+                return checkGps () | checkQueue ();
+            default:
+                usage ();
+        }
+    }
+    if (optind < argc) input = argv[optind];
+
+    FrskySPTermios spIn = strcmp (input, "-") ? FrskySPTermios (input) : FrskySPTermios (STDIN_FILENO);
+    FrskyDTermios  dIn  = strcmp (input, "-") ? FrskyDTermios (input)  : FrskyDTermios (STDIN_FILENO);
+    class FrskyD   dDecoder (dIn);
+
+    if (sp) { spIn.begin (FRSKY_SP_SPEED); fd = spIn.fd (); }
+    else    { dIn.begin (FRSKY_D_SPEED);   fd = dIn.fd (); }
+    if (fd < 0) {
+        perror (input);
+        return 1;
+    }
+    live = fstat (fd, &st) == 0 && !S_ISREG (st.st_mode);
+    dDecoder.onValue (onValue);
+
+    if (format == CSV) fputs ("offset,event,phys,type,proto,id,crc,value\n", out);
+    clock::time_point start = clock::now ();
+
+    for (;;) {
+        n = read (fd, buf, sizeof (buf));
+        if ((n < 0 && (errno == EAGAIN || errno == EINTR)) || (n == 0 && isatty (fd))) {
+            struct pollfd pfd = {fd, POLLIN, 0};
+            poll (&pfd, 1, -1);             // wait for the next bytes
+            continue;
+        }
+        if (n <= 0) break;
+
+        for (i=0; i<n; i++, offset++) {
+            if (!sp) {
+                dDecoder.feed (buf[i]);
+                continue;
+            }
+            event = spDecoder.feed (buf[i]);
+            if (event == FRSKY_SP_EVENT_NONE || (event == FRSKY_SP_EVENT_POLL && !polls)) continue;
+            if (event < FRSKY_SP_EVENT_PACKET || event > FRSKY_SP_EVENT_BAD_CRC)
+                record (event, 's', spDecoder.polled (), 0, 0, 0, 0);
+            else
+                record (event, 's', spDecoder.polled (), spDecoder.type (), spDecoder.id (), spDecoder.packet ()[7],
+                        spDecoder.value ());
+        }
+        if (live) {
+            flush ();
+            fflush (out);
+        }
+    }
+    flush ();
+    fflush (out);
+
+    double s = std::chrono::duration<double> (clock::now () - start).count ();
+    unsigned long packets = counts[FRSKY_SP_EVENT_PACKET] + counts[FRSKY_SP_EVENT_EMPTY];
+    fprintf (stderr, "%llu bytes, %lu packets", (unsigned long long) offset, packets);
+    for (i=FRSKY_SP_EVENT_BAD_CRC; i<=FRSKY_SP_EVENT_BAD_ID; i++) {
+        if (counts[i]) fprintf (stderr, ", %lu %s", counts[i], events[i]);
+    }
+    fprintf (stderr, " in %.3f s (%.0f packets/s)\n", s, s > 0 ? packets / s : 0);
+    return 0;
+}
@@ -0,0 +1,229 @@
+/*
+ * Record a bus session in a timestamped capture (see capture.h), replay it, and query it by sensor.
+ *
+ * Usage
+ * -----
+ * make fcap
+ * ./fcap record [-p sp|d] [-t seconds] input capture.fcap
+ * ./fcap replay [-r speed] [-a] capture.fcap
+ * ./fcap query capture.fcap id [id ...]
+ * ./fcap info capture.fcap
+ *
+ * record  reads a tty (set raw, at the speed of the protocol), a pty or a fifo until interrupted (or for -t seconds),
+ *         and timestamps each byte. A raw file (ex. a dump) is converted with the timing of the line speed.
+ * replay  feeds the FrskySP / FrskyD decoders with the bytes, as fast as possible or in real time (-r 1, -r 2 for
+ *         twice as fast), and outputs the packets as JSON lines (-a: the polls as well).
+ * query   outputs every packet of the logical IDs (ex. 0x0500) as CSV (time [µs], ID, value), from the index only.
+ * info    outputs the header, and the number of packets per ID.
+ *
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#include "capture.h"
+
+#include <chrono>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static volatile bool stop = false;          // set by SIGINT / SIGTERM
+
+static void onSignal (int) {
+    stop = true;
+}
+
+static void usage () {
+    fprintf (stderr, "usage: fcap record [-p sp|d] [-t seconds] input capture.fcap\n"
+                     "       fcap replay [-r speed] [-a] capture.fcap\n"
+                     "       fcap query capture.fcap id [id ...]\n"
+                     "       fcap info capture.fcap\n");
+    exit (2);
+}
+
+/*
+ * Monotonic time [µs].
+ */
+static uint64_t now () {
+    return std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+static int record (int argc, char **argv) {
+    char           protocol = 'S';
+    double         seconds = 0;
+    int            opt, fd;
+    uint8_t        buf[4096];
+    ssize_t        n, i;
+    struct stat    st;
+    struct timeval tv;
+    uint64_t       t = 0, last = 0, end = 0, byteUs;
+    bool           live;
+
+    while ((opt = getopt (argc, argv, "p:t:")) != -1) {
+        switch (opt) {
+            case 'p': protocol = strcmp (optarg, "d") ? 'S' : 'D'; break;
+            case 't': seconds = atof (optarg); break;
+            default:  usage ();
+        }
+    }
+    if (argc - optind != 2) usage ();
+
+    long speed = protocol == 'D' ? FRSKY_D_SPEED : FRSKY_SP_SPEED;
+    FrskySPTermios line (argv[optind]);     // used to open and set the line only (the protocol does not matter)
+    CaptureWriter  writer (protocol);
+
+    line.begin (speed);
+    if ((fd = line.fd ()) < 0) {
+        perror (argv[optind]);
+        return 1;
+    }
+    live   = fstat (fd, &st) == 0 && !S_ISREG (st.st_mode);
+    byteUs = 10000000 / speed;              // 10 bits per byte
+    gettimeofday (&tv, NULL);
+    if (!writer.open (argv[optind + 1], speed, live ? (uint64_t) tv.tv_sec * 1000000 + tv.tv_usec : 0)) {
+        perror (argv[optind + 1]);
+        return 1;
+    }
+    signal (SIGINT, onSignal);
+    signal (SIGTERM, onSignal);
+    if (seconds > 0) end = now () + (uint64_t) (seconds * 1e6);
+
+    while (!stop && (!end || now () < end)) {
+        n = read (fd, buf, sizeof (buf));
+        if ((n < 0 && (errno == EAGAIN || errno == EINTR)) || (n == 0 && live)) {
+            struct pollfd pfd = {fd, POLLIN, 0};
+            poll (&pfd, 1, 100);            // check stop and end now and then
+            continue;
+        }
+        if (n <= 0) break;
+
+        if (live) t = now () - (n - 1) * byteUs;    // the last byte was received now
+        for (i = 0; i < n; i++, t += byteUs) {
+            if (t < last) t = last;
+            writer.write (buf[i], t);
+            last = t;
+        }
+    }
+    if (!writer.close ()) {
+        perror (argv[optind + 1]);
+        return 1;
+    }
+    return 0;
+}
+
+static int replay (int argc, char **argv) {
+    CaptureReader reader;
+    double        speed = 0;
+    bool          polls = false;
+    int           opt;
+    unsigned long packets = 0;
+
+    while ((opt = getopt (argc, argv, "r:a")) != -1) {
+        switch (opt) {
+            case 'r': speed = atof (optarg); break;
+            case 'a': polls = true; break;
+            default:  usage ();
+        }
+    }
+    if (argc - optind != 1) usage ();
+    if (!reader.open (argv[optind])) {
+        fprintf (stderr, "%s: not a capture\n", argv[optind]);
+        return 1;
+    }
+
+    static uint64_t time;                   // time of the byte being replayed, for the FrskyD handler
+    FrskySPDecoder  sp;
+    FrskyDTermios   none (-1);
+    class FrskyD    d (none);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+
+    d.onValue ([] (uint8_t id, int16_t val) {
+        printf ("{\"time\":%llu,\"event\":\"packet\",\"id\":%u,\"value\":%d}\n", (unsigned long long) time, id, val);
+    });
+
+    reader.replay ([&] (uint8_t b, uint16_t flags, uint64_t t) {
+        uint8_t event;
+
+        time = t;
+        if (reader.header ().protocol == 'D') {
+            packets += d.feed (b);
+            return;
+        }
+        event = sp.feed (b);
+        if (event == FRSKY_SP_EVENT_POLL && polls)
+            printf ("{\"time\":%llu,\"event\":\"poll\",\"phys\":%d}\n", (unsigned long long) t, sp.polled ());
+        if (event == FRSKY_SP_EVENT_PACKET) {
+            printf ("{\"time\":%llu,\"event\":\"packet\",\"phys\":%d,\"id\":%u,\"value\":%d}\n", (unsigned long long) t,
+                    sp.polled (), sp.id (), (int32_t) sp.value ());
+            packets++;
+        }
+        if (speed > 0) fflush (stdout);
+    }, speed);
+
+    fflush (stdout);
+    double s = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+    fprintf (stderr, "%llu records, %lu packets in %.3f s\n", (unsigned long long) reader.records (), packets, s);
+    return 0;
+}
+
+static int query (int argc, char **argv) {
+    CaptureReader       reader;
+    const CaptureEntry *e;
+    uint32_t            count, i;
+    unsigned long       total = 0;
+    int                 a;
+
+    if (argc < 4) usage ();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    if (!reader.open (argv[2])) {
+        fprintf (stderr, "%s: not a capture\n", argv[2]);
+        return 1;
+    }
+    for (a = 3; a < argc; a++) {
+        uint16_t id = strtoul (argv[a], NULL, 0);
+
+        e = reader.find (id, &count);
+        for (i = 0; i < count; i++) printf ("%llu,%u,%d\n", (unsigned long long) e[i].time, id, e[i].value);
+        total += count;
+    }
+    fflush (stdout);
+    double s = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+    fprintf (stderr, "%lu packets in %.3f ms\n", total, s * 1e3);
+    return 0;
+}
+
+static int info (int argc, char **argv) {
+    CaptureReader     reader;
+    const CaptureDir *dir;
+    uint64_t          duration = 0;
+    uint32_t          i, count;
+
+    if (argc != 3) usage ();
+    if (!reader.open (argv[2])) {
+        fprintf (stderr, "%s: not a capture\n", argv[2]);
+        return 1;
+    }
+    reader.replay ([&] (uint8_t, uint16_t, uint64_t t) { duration = t; });
+    printf ("protocol %s, %u bds, start %llu, %llu records, %.3f s\n", reader.header ().protocol == 'D' ? "D" : "SP",
+            reader.header ().speed, (unsigned long long) reader.header ().start,
+            (unsigned long long) reader.records (), duration / 1e6);
+    for (i = 0, dir = reader.dir (); i < reader.trailer ().ids; i++) {
+        reader.find (dir[i].id, &count);
+        printf ("0x%04x %u\n", dir[i].id, count);
+    }
+    return 0;
+}
+
+int main (int argc, char **argv) {
+    if (argc < 2) usage ();
+    if (!strcmp (argv[1], "record")) return record (argc - 1, argv + 1);
+    if (!strcmp (argv[1], "replay")) return replay (argc - 1, argv + 1);
+    if (!strcmp (argv[1], "query"))  return query (argc, argv);
+    if (!strcmp (argv[1], "info"))   return info (argc, argv);
+    usage ();
+}
@@ -0,0 +1,67 @@
+/*
+ * Footprint report: RAM taken by each feature of the FrskySP and FrskyD libraries, as compiled here.
+ *
+ * Usage
+ * -----
+ * make size       this report, then the code size of each library object (text: flash, data + bss: static RAM)
+ * ./footprint
+ *
+ * The figures are the ones of this host: pointers take 8 bytes here, 2 on AVR, and int 4 bytes instead of 2. They
+ * tell what grows when a feature is added, and which object holds what - the absolute figures of a board are given by
+ * the Arduino IDE (or avr-size) on the sketch.
+ *
+ * RAM is counted where it is taken:
+ * * static - global objects (known at link time): FrskySPPins, FrskyDPins, slots, histograms,
+ * * heap - allocated at run time: the SoftwareSerial transport of FrskySP(int, int) and FrskyD(int, int), the queue
+ *   of FrskyD::async(),
+ * * const - tables kept in flash on ARM, but copied to RAM on AVR (no PROGMEM) when they are linked.
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#include <stdio.h>
+
+#include "FrskySP.h"
+#include "FrskySPDecoder.h"
+#include "FrskyD.h"
+
+/**
+ * \brief Print one line of the report
+ * \param feature feature
+ * \param object object holding it
+ * \param where static, heap, const or "-" (part of the object above)
+ * \param bytes size [bytes]
+ */
+static void line (const char *feature, const char *object, const char *where, size_t bytes) {
+    printf ("%-22s %-34s %-7s %6zu\n", feature, object, where, bytes);
+}
+
+int main () {
+    printf ("%-22s %-34s %-7s %6s\n", "feature", "object", "RAM", "bytes");
+
+    printf ("\nFrskySP (FRSKY_SP_TIMING %d)\n", FRSKY_SP_TIMING);
+    line ("bus",              "FrskySP",                        "static", sizeof (FrskySP));
+    line ("  bus counters",   "FrskySPStats",                   "-",      sizeof (FrskySPStats));
+    line ("SoftwareSerial",   "FrskySPSoftSerial",              "heap",   sizeof (FrskySPSoftSerial));
+    line ("bus, pins",        "FrskySPPins<10, 11>",            "static", sizeof (FrskySPPins<10, 11>));
+    line ("pre-encoded answer", "FrskySPSlot",                  "static", sizeof (FrskySPSlot));
+    line ("latency histogram", "FrskySPTiming",                 "static", sizeof (FrskySPTiming));
+    line ("stream decoder",   "FrskySPDecoder",                 "static", sizeof (FrskySPDecoder));
+    line ("multi-bus pump",   "FrskySPPump",                    "static", sizeof (FrskySPPump));
+    line ("task scheduler",   "FrskySPScheduler",               "static", sizeof (FrskySPScheduler));
+    line ("rpm from edges",   "FrskySPRpm",                     "static", sizeof (FrskySPRpm));
+    line ("rpm from counts",  "FrskySPFreq",                    "static", sizeof (FrskySPFreq));
+    line ("sensor table",     "FrskySPSensors::table",          "const",  sizeof (FrskySPSensors::table));
+
+    printf ("\nFrskyD\n");
+    line ("line",             "FrskyD",                         "static", sizeof (FrskyD));
+    line ("  line counters",  "FrskyDStats",                    "-",      sizeof (FrskyDStats));
+    line ("SoftwareSerial",   "FrskyDSoftSerial",               "heap",   sizeof (FrskyDSoftSerial));
+    line ("line, pins",       "FrskyDPins<10, 11>",             "static", sizeof (FrskyDPins<10, 11>));
+    line ("async sending",    "FrskyDTxQueue",                  "heap",   sizeof (FrskyDTxQueue));
+    line ("sensor table",     "FrskyDSensors::table",           "const",  sizeof (FrskyDSensors::table));
+
+    printf ("\nSoftwareSerial is the host stand-in (shim/): on AVR, it takes about 30 bytes per object, and its\n"
+            "64 bytes receive buffer is static, shared by all the objects.\n");
+    return 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * \file Arduino.cpp
+ *
+ * Stand-in for the Arduino core (see Arduino.h).
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#include "Arduino.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+uint8_t hostPinMode[HOST_PINS];
+uint8_t hostPinLevel[HOST_PINS];
+
+HostSerial Serial;
+
+static std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now ();
+static bool          _virtual = false;      // see hostTimeSet ()
+static unsigned long _us = 0;               // virtual time [µs]
+
+void pinMode (uint8_t pin, uint8_t mode) {
+    if (pin < HOST_PINS) hostPinMode[pin] = mode;
+}
+
+void digitalWrite (uint8_t pin, uint8_t val) {
+    if (pin < HOST_PINS) hostPinLevel[pin] = val;
+}
+
+int digitalRead (uint8_t pin) {
+    return (pin < HOST_PINS) ? hostPinLevel[pin] : LOW;
+}
+
+unsigned long millis () {
+    if (_virtual) return _us / 1000;
+    return std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - _start).count ();
+}
+
+unsigned long micros () {
+    if (_virtual) return _us;
+    return std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - _start).count ();
+}
+
+void delay (unsigned long ms) {
+    if (_virtual) return hostTimeAdvance (ms * 1000);
+    std::this_thread::sleep_for (std::chrono::milliseconds (ms));
+}
+
+void delayMicroseconds (unsigned int us) {
+    if (_virtual) return hostTimeAdvance (us);
+    std::this_thread::sleep_for (std::chrono::microseconds (us));
+}
+
+void hostTimeSet (unsigned long us) {
+    _virtual = true;
+    _us      = us;
+}
+
+void hostTimeAdvance (unsigned long us) {
+    _virtual = true;
+    _us     += us;
+}
+
+static std::string _itoa (unsigned long val, int base, bool neg) {
+    char buf[8 * sizeof (long) + 2];
+    char *p = buf + sizeof (buf) - 1;
+
+    *p = 0;
+    do {
+        int d = val % base;
+        *--p = d < 10 ? '0' + d : 'A' + d - 10;
+        val /= base;
+    } while (val);
+    if (neg) *--p = '-';
+    return std::string (p);
+}
+
+String::String (int val, int base)           : _s (_itoa (val < 0 && base == DEC ? -(long) val : (unsigned int) val, base, val < 0 && base == DEC)) {}
+String::String (unsigned int val, int base)  : _s (_itoa (val, base, false)) {}
+String::String (long val, int base)          : _s (_itoa (val < 0 && base == DEC ? -val : (unsigned long) val, base, val < 0 && base == DEC)) {}
+String::String (unsigned long val, int base) : _s (_itoa (val, base, false)) {}
+
+String::String (float val, int decimals) : String ((double) val, decimals) {}
+
+String::String (double val, int decimals) {
+    char buf[48];
+    snprintf (buf, sizeof (buf), "%.*f", decimals, val);
+    this->_s = buf;
+}
+
+size_t HostSerial::print (const char *s) {
+    size_t n = strlen (s);
+    this->count += n;
+    return n;
+}
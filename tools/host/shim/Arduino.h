@@ -0,0 +1,108 @@
+/**
+ * \file Arduino.h
+ *
+ * Stand-in for the Arduino core, used to build FrskySP and FrskyD on Linux.
+ *
+ * Only what the libraries and the host tools use is provided. Pins are not connected to anything: pinMode() and
+ * digitalWrite() only record the last state, so that the RX freeze workaround and the LED toggling can be checked.
+ * Serial is a sink - the debug prints of the libraries are counted, not shown. The clock is the host clock, or a
+ * virtual one (see hostTimeSet()).
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#ifndef FRSKY_HOST_ARDUINO_H
+#define FRSKY_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+typedef uint8_t  byte;
+typedef bool     boolean;
+typedef uint16_t word;
+
+#define LOW     0
+#define HIGH    1
+#define INPUT   0
+#define OUTPUT  1
+
+#define DEC     10
+#define HEX     16
+
+#define HOST_PINS 64                        //!<number of emulated pins
+
+void          pinMode (uint8_t pin, uint8_t mode);
+void          digitalWrite (uint8_t pin, uint8_t val);
+int           digitalRead (uint8_t pin);
+unsigned long millis ();
+unsigned long micros ();
+void          delay (unsigned long ms);
+void          delayMicroseconds (unsigned int us);
+
+/**
+ * Virtual clock, for the simulations: once hostTimeSet() is called, millis() and micros() return the virtual time,
+ * that only moves with hostTimeSet(), hostTimeAdvance(), delay() and delayMicroseconds() - which do not sleep anymore.
+ */
+void          hostTimeSet (unsigned long us);
+void          hostTimeAdvance (unsigned long us);
+
+/**
+ * Last mode and level set on each emulated pin
+ */
+extern uint8_t hostPinMode[HOST_PINS];
+extern uint8_t hostPinLevel[HOST_PINS];
+
+/**
+ * Minimal Arduino String, backed by std::string
+ */
+class String {
+    public:
+        String ()                   {}
+        String (const char *s)      : _s (s) {}
+        String (const std::string &s) : _s (s) {}
+        String (char c)             : _s (1, c) {}
+        String (int val, int base = DEC);
+        String (unsigned int val, int base = DEC);
+        String (long val, int base = DEC);
+        String (unsigned long val, int base = DEC);
+        String (float val, int decimals = 2);
+        String (double val, int decimals = 2);
+
+        const char   *c_str () const  { return this->_s.c_str (); }
+        unsigned int  length () const { return this->_s.length (); }
+
+        String &operator += (const String &rhs) { this->_s += rhs._s; return *this; }
+        friend String operator + (const String &lhs, const String &rhs) { return String (lhs._s + rhs._s); }
+        friend String operator + (const String &lhs, const char *rhs)   { return String (lhs._s + rhs); }
+        friend bool   operator == (const String &lhs, const String &rhs) { return lhs._s == rhs._s; }
+
+    private:
+        std::string _s;
+};
+
+/**
+ * Serial port sink: everything printed is counted and dropped
+ */
+class HostSerial {
+    public:
+        void   begin (unsigned long baud) { (void) baud; }
+        size_t write (uint8_t val)        { (void) val; this->count++; return 1; }
+        size_t print (const char *s);
+        size_t print (const String &s)    { return this->print (s.c_str ()); }
+        size_t print (char c)             { return this->write (c); }
+        size_t print (int val, int base = DEC)           { return this->print (String (val, base)); }
+        size_t print (unsigned int val, int base = DEC)  { return this->print (String (val, base)); }
+        size_t print (long val, int base = DEC)          { return this->print (String (val, base)); }
+        size_t print (unsigned long val, int base = DEC) { return this->print (String (val, base)); }
+        size_t print (double val, int decimals = 2)      { return this->print (String (val, decimals)); }
+        size_t println ()                 { return this->print ("\r\n"); }
+        template <typename T> size_t println (T val)              { return this->print (val) + this->println (); }
+        template <typename T> size_t println (T val, int format)  { return this->print (val, format) + this->println (); }
+
+        unsigned long count = 0;            //!<bytes printed so far
+};
+
+extern HostSerial Serial;
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * \file SoftwareSerial.cpp
+ *
+ * Stand-in for the Arduino SoftwareSerial library (see SoftwareSerial.h).
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#include "SoftwareSerial.h"
+
+SoftwareSerial::SoftwareSerial (uint8_t receivePin, uint8_t transmitPin, bool inverse_logic) {
+    (void) inverse_logic;
+    pinMode (receivePin, INPUT);
+    pinMode (transmitPin, OUTPUT);
+}
+
+int SoftwareSerial::available () {
+    return (this->_rxTail + _SS_MAX_RX_BUFF - this->_rxHead) % _SS_MAX_RX_BUFF;
+}
+
+int SoftwareSerial::peek () {
+    if (this->_rxHead == this->_rxTail) return -1;
+    return this->_rxBuf[this->_rxHead];
+}
+
+int SoftwareSerial::read () {
+    if (this->_rxHead == this->_rxTail) return -1;
+    uint8_t d = this->_rxBuf[this->_rxHead];
+    this->_rxHead = (this->_rxHead + 1) % _SS_MAX_RX_BUFF;
+    return d;
+}
+
+size_t SoftwareSerial::write (uint8_t val) {
+    this->_txBuf[this->_txCount++ & (_SS_HOST_TX_BUFF - 1)] = val;
+    return 1;
+}
+
+/**
+ * Push bytes in the RX buffer, as if they were received on the line
+ * \return number of bytes stored (the rest is lost, and overflow() is set)
+ */
+size_t SoftwareSerial::hostInject (const uint8_t *buf, size_t len) {
+    size_t i;
+    for (i = 0; i < len; i++) {
+        uint8_t next = (this->_rxTail + 1) % _SS_MAX_RX_BUFF;
+        if (next == this->_rxHead) {
+            this->_overflow = true;
+            break;
+        }
+        this->_rxBuf[this->_rxTail] = buf[i];
+        this->_rxTail = next;
+    }
+    return i;
+}
+
+/**
+ * Read back the next byte written by the library
+ * \return byte, or -1 if nothing is left (or if it was overwritten)
+ */
+int SoftwareSerial::hostTxRead () {
+    if (this->_txCount - this->_txRead > _SS_HOST_TX_BUFF) this->_txRead = this->_txCount - _SS_HOST_TX_BUFF;
+    if (this->_txRead == this->_txCount) return -1;
+    return this->_txBuf[this->_txRead++ & (_SS_HOST_TX_BUFF - 1)];
+}
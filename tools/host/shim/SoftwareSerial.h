@@ -0,0 +1,56 @@
+/**
+ * \file SoftwareSerial.h
+ *
+ * Stand-in for the Arduino SoftwareSerial library, used to build FrskySP and FrskyD on Linux.
+ *
+ * There is no line behind it. The host side feeds the RX buffer with hostInject() (as if the receiver had sent the
+ * bytes), and reads back what the library has written with hostTxRead(). Like the genuine library, the RX buffer is
+ * limited to 64 bytes and flags an overflow when full. Written bytes are kept in a 256 bytes ring, older ones are
+ * overwritten.
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#ifndef FRSKY_HOST_SOFTWARESERIAL_H
+#define FRSKY_HOST_SOFTWARESERIAL_H
+
+#include "Arduino.h"
+
+#define _SS_MAX_RX_BUFF 64                  //!<RX buffer size, as in the genuine library
+#define _SS_HOST_TX_BUFF 256                //!<TX capture size (power of 2)
+
+class SoftwareSerial {
+    public:
+        SoftwareSerial (uint8_t receivePin, uint8_t transmitPin, bool inverse_logic = false);
+
+        void   begin (long speed)   { this->_speed = speed; }
+        void   end ()               {}
+        bool   listen ()            { return false; }
+        bool   isListening ()       { return true; }
+        bool   overflow ()          { bool r = this->_overflow; this->_overflow = false; return r; }
+        int    available ();
+        int    peek ();
+        int    read ();
+        size_t write (uint8_t val);
+        void   flush ()             {}
+
+        // host side
+        size_t        hostInject (const uint8_t *buf, size_t len);
+        size_t        hostTxAvailable () const { return this->_txCount - this->_txRead; }
+        int           hostTxRead ();
+        void          hostTxClear ()           { this->_txRead = this->_txCount; }
+        unsigned long hostTxCount () const     { return this->_txCount; }
+        long          hostSpeed () const       { return this->_speed; }
+
+    private:
+        uint8_t       _rxBuf[_SS_MAX_RX_BUFF];
+        uint8_t       _rxHead = 0;
+        uint8_t       _rxTail = 0;
+        bool          _overflow = false;
+        uint8_t       _txBuf[_SS_HOST_TX_BUFF];
+        unsigned long _txCount = 0;         //!<bytes written since construction
+        unsigned long _txRead = 0;          //!<bytes read back by the host
+        long          _speed = 0;
+};
+
+#endif
@@ -0,0 +1,439 @@
+/*
+ * X8R receiver simulator: drives the Smart Port poll cycle into FrskySP sensors, through a virtual bus and in virtual
+ * time (see hostTimeSet()), and measures how the sensors answer.
+ *
+ * Usage
+ * -----
+ * make x8r && ./x8r [-t seconds] [-p poll_us] [-w work_us] [-j jitter_us] [-b block_us] [-T turnaround_us]
+ *                   [-u update_us] [-k deadline_us] [-S] [-r seed] [-s phys[:id]] ...
+ * make x8r && ./x8r -C
+ *
+ * -t  simulated time (10 s)
+ * -p  poll period (11000 µs)
+ * -s  a sensor answering on a physical ID (0~27) with a logical ID (FRSKY_SP_RPM by default) - repeat it for more
+ *     sensors, or for 2 sensors on the same physical ID (4 by default)
+ * -w  time taken by each loop() of the sensors, besides FrskySP::update() (100 µs)
+ * -j  random extra time of each loop() (0~jitter_us, 0 by default)
+ * -b  once per second, a loop() takes block_us more (ex. a slow sensor read, 0 by default)
+ * -S  the slow sensor read of -b is a FrskySPScheduler task: it only runs where it ends before the next poll
+ * -T  turnaround of the sensors' transport (174 µs, as SoftwareSerial: 1 bit)
+ * -u  time between 2 new values of a sensor (0: a new value at each loop(), the default)
+ * -k  keep-alive: the sensors answer every poll, with the empty packet when no new value came within deadline_us
+ *     after the poll (see FrskySP::keepAlive() and FrskySP::deadline())
+ * -C  check only: 2 polls buffered at once (a late loop()) - only the last one must be answered (exit status 1 if not)
+ *
+ * Receiver
+ * --------
+ * As described in the FrskySP main page: one poll (0x7E, physical ID) every poll period. As long as one physical ID
+ * only has answered, the receiver alternates this ID and the next one to search. Otherwise, it polls the 28 IDs in
+ * sequence.
+ *
+ * Each poll opens a slot, closed by the next poll. For each physical ID, the simulator counts:
+ * * replies - valid answers, and their latency (from the end of the poll to the start of the answer),
+ * * empty - empty answers (type 0, ID 0, value 0, CRC 0xFF),
+ * * bad - answers with a wrong CRC, cut, or too long,
+ * * missed - polls of an ID that has answered before, without any answer,
+ * * late - answers still being sent when the next poll starts,
+ * * collisions - answers sent at the same time by 2 sensors.
+ *
+ * As on a real bus, the receiver does not know who answers: a late answer may be taken as the answer to the next poll.
+ *
+ * The sensors receive the bus through a 64 bytes buffer, as SoftwareSerial does (see overflows in the output), and
+ * their clock stops while they send a byte (SoftwareSerial::write() waits for the byte).
+ *
+ * Built with TIMING=1 (see Makefile), the latency measured by each sensor (see FrskySP::measure()) is shown too.
+ *
+ *
+ * origin: https://github.com/jcheger/frsky-arduino
+ */
+
+#include <FrskySP.h>
+
+#include <algorithm>
+#include <deque>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#define BYTE_US  ((10 * 1000000L + FRSKY_SP_SPEED / 2) / FRSKY_SP_SPEED)   // 174 µs
+#define RX_SIZE  64                         // SoftwareSerial RX buffer
+
+/*
+ * One byte on the bus: start time [µs], value, and sender (-1: receiver, else sensor index).
+ */
+struct WireByte {
+    unsigned long start;
+    uint8_t       b;
+    int           sender;
+};
+
+class SimPort;
+
+/*
+ * The wire: every byte sent is delivered to the other ports, and kept for the receiver.
+ */
+class SimBus {
+    public:
+        void transmit (unsigned long start, uint8_t b, int sender);
+
+        std::vector<SimPort *> ports;
+        std::vector<WireByte>  heard;       // bytes sent by the sensors, not analysed by the receiver yet
+};
+
+/*
+ * Virtual transport of one sensor.
+ */
+class SimPort : public FrskySPTransport {
+    public:
+        SimPort (SimBus &bus, int index, uint16_t turnaround) : _bus (bus), _index (index), _turnaround (turnaround) {}
+
+        int available () {
+            int n = 0;
+
+            for (const WireByte &w : this->_rx) {
+                if (w.start + BYTE_US > micros ()) break;
+                n++;
+            }
+            return n;
+        }
+
+        void begin (long speed) {
+            this->_speed = speed;
+        }
+
+        int read () {
+            int b;
+
+            if (!this->available ()) return -1;
+            b = this->_rx.front ().b;
+            this->_rx.pop_front ();
+            return b;
+        }
+
+        uint16_t turnaround () const {
+            return this->_turnaround;
+        }
+
+        void txBegin () {
+            this->_first = true;
+        }
+
+        size_t write (uint8_t val) {
+            unsigned long start = micros () + (this->_first ? this->_turnaround : 0);
+
+            this->_first = false;
+            this->_bus.transmit (start, val, this->_index);
+            hostTimeSet (start + BYTE_US);  // SoftwareSerial waits for the byte
+            return 1;
+        }
+
+        void deliver (const WireByte &w) {
+            if (this->_rx.size () < RX_SIZE) this->_rx.push_back (w);
+            else                             this->overflows++;
+        }
+
+        unsigned long overflows = 0;
+
+    private:
+        SimBus               &_bus;
+        int                   _index;
+        uint16_t              _turnaround;
+        bool                  _first = true;
+        std::deque<WireByte>  _rx;
+};
+
+void SimBus::transmit (unsigned long start, uint8_t b, int sender) {
+    WireByte w = {start, b, sender};
+
+    int i;
+
+    for (i=0; i<(int) this->ports.size (); i++) {
+        if (i != sender) this->ports[i]->deliver (w);
+    }
+    if (sender >= 0) this->heard.push_back (w);
+}
+
+/*
+ * A sensor: FrskySP on its own port, answering one physical ID with one slot.
+ */
+struct Sensor {
+    SimPort       *port;
+    class FrskySP *sp;
+    FrskySPSlot   *slot;
+    FrskySPTiming  timing;                  // latency seen by the sensor (FRSKY_SP_TIMING)
+    unsigned long  next;                    // time of the next loop()
+    unsigned long  nextBlock;               // time of the next long loop()
+    unsigned long  nextValue;               // time of the next new value
+    FrskySPScheduler *tasks;                // see -S
+};
+
+/*
+ * Figures of a physical ID.
+ */
+struct Stats {
+    unsigned long polls, replies, empty, bad, missed, late, collisions;
+    unsigned long latMin, latMax;
+    double        latSum;
+    bool          present;
+};
+
+static Stats    stats[FRSKY_SP_PHYSICAL_IDS];
+static uint32_t seed = 1;
+static unsigned long blockUs = 0;
+
+/*
+ * The slow sensor read of -b, as a scheduler task (-S).
+ */
+static void blockTask () {
+    hostTimeAdvance (blockUs);
+}
+
+static uint32_t rnd () {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+static void usage () {
+    fprintf (stderr, "usage: x8r [-t seconds] [-p poll_us] [-w work_us] [-j jitter_us] [-b block_us] [-T turnaround_us]"
+                     " [-u update_us] [-k deadline_us] [-S] [-r seed] [-s phys[:id]] ...\n"
+                     "       x8r -C\n");
+    exit (2);
+}
+
+/*
+ * -C: a sensor on physical IDs 4 and 7 finds the polls of 4 and 7 buffered at once. The poll of 4 is over (the poll
+ * of 7 follows it): only 7 must be answered, and 4 counted as an underflow.
+ */
+static int checkStale () {
+    class FrskySP sp (10, 11);
+    FrskySPSlot   rpm (FRSKY_SP_RPM);
+    FrskySPSlot   air (FRSKY_SP_AIR_SPEED);
+    FrskySPDecoder decoder;
+    uint8_t       polls[] = {FRSKY_SP_POLL, FrskySPCrc::physicalId (4), FRSKY_SP_POLL, FrskySPCrc::physicalId (7)};
+    int           b, n = 0, ok;
+
+    sp.attach (4, &rpm);
+    sp.attach (7, &air);
+    rpm.set (1000);
+    air.set (100);
+    sp.mySerial->hostInject (polls, sizeof (polls));
+    sp.update ();
+    decoder.feed (FRSKY_SP_POLL);
+    decoder.feed (FrskySPCrc::physicalId (7));
+    while ((b = sp.mySerial->hostTxRead ()) >= 0) {
+        if (decoder.feed (b) != FRSKY_SP_EVENT_PACKET) continue;
+        n += decoder.id () == FRSKY_SP_AIR_SPEED ? 1 : 100;
+    }
+    ok = n == 1 && sp.stats ().polls[4] == 1 && sp.stats ().underflows == 1;
+    printf ("stale polls: %s (answers to 7: %d, to 4: %d, underflows: %u)\n", ok ? "ok" : "FAILED", n % 100, n / 100,
+            sp.stats ().underflows);
+    return ok ? 0 : 1;
+}
+
+/*
+ * Close the slot of a poll: analyse the bytes heard between the end of the poll and the next poll.
+ */
+static void closeSlot (SimBus &bus, int id, int prev, unsigned long pollEnd, unsigned long next) {
+    std::vector<WireByte> reply;
+    std::vector<WireByte> keep;
+    FrskySPDecoder        decoder;
+    Stats                &s = stats[id];
+    bool                  late = false, collision = false, early = false;
+    uint8_t               event = FRSKY_SP_EVENT_NONE, e;
+    unsigned long         latency;
+    size_t                i;
+
+    std::sort (bus.heard.begin (), bus.heard.end (), [] (const WireByte &a, const WireByte &b) { return a.start < b.start; });
+    for (const WireByte &w : bus.heard) {
+        if (w.start >= next)        keep.push_back (w);
+        else if (w.start < pollEnd) early = true;   // over this poll: late answer to the previous one
+        else                        reply.push_back (w);
+    }
+    bus.heard.swap (keep);
+    if (early && prev >= 0) stats[prev].late++;
+
+    if (reply.empty ()) {
+        if (s.present) s.missed++;
+        return;
+    }
+    for (i=1; i<reply.size (); i++) {
+        if (reply[i].start < reply[i - 1].start + BYTE_US || reply[i].sender != reply[0].sender) collision = true;
+    }
+    if (reply.back ().start + BYTE_US > next) late = true;
+    if (collision) { s.collisions++; return; }
+    if (late)      { s.late++;       return; }
+
+    decoder.feed (FRSKY_SP_POLL);
+    decoder.feed (FrskySPCrc::physicalId (id));
+    for (const WireByte &w : reply) {
+        if ((e = decoder.feed (w.b)) != FRSKY_SP_EVENT_NONE) event = e;
+    }
+    if ((e = decoder.feed (FRSKY_SP_POLL)) != FRSKY_SP_EVENT_NONE) event = e;   // a cut answer shows now
+
+    if (event == FRSKY_SP_EVENT_PACKET) {
+        latency = reply[0].start - pollEnd;
+        if (s.replies == 0 || latency < s.latMin) s.latMin = latency;
+        if (latency > s.latMax) s.latMax = latency;
+        s.latSum += latency;
+        s.replies++;
+        s.present = true;
+    }
+    else if (event == FRSKY_SP_EVENT_EMPTY) {
+        s.empty++;
+        s.present = true;
+    }
+    else s.bad++;
+}
+
+/*
+ * Next physical ID to poll (see Receiver above).
+ */
+static int nextId () {
+    static int  search = -1;
+    static bool searching = true;
+    int present = -1, n = 0, i;
+
+    for (i=0; i<FRSKY_SP_PHYSICAL_IDS; i++) {
+        if (stats[i].present) { present = i; n++; }
+    }
+    if (n == 1) {
+        searching = !searching;
+        if (!searching) return present;
+    }
+    do search = (search + 1) % FRSKY_SP_PHYSICAL_IDS; while (n == 1 && search == present);
+    return search;
+}
+
+int main (int argc, char **argv) {
+    double         seconds = 10;
+    unsigned long  period = 11000, work = 100, jitter = 0, block = 0, update = 0, end, poll, pollEnd = 0;
+    long           keep = -1;
+    bool           scheduled = false;
+    uint16_t       turnaround = BYTE_US;
+    std::vector<std::pair<int, uint16_t> > config;
+    std::vector<Sensor> sensors;
+    SimBus         bus;
+    int            opt, id = -1, prev = -1, i;
+    Sensor        *s;
+
+    while ((opt = getopt (argc, argv, "Ct:p:w:j:b:T:u:k:Sr:s:")) != -1) {
+        switch (opt) {
+            case 'C': return checkStale ();
+            case 't': seconds = atof (optarg); break;
+            case 'p': period = strtoul (optarg, NULL, 0); break;
+            case 'w': work = strtoul (optarg, NULL, 0); break;
+            case 'j': jitter = strtoul (optarg, NULL, 0); break;
+            case 'b': block = strtoul (optarg, NULL, 0); break;
+            case 'T': turnaround = strtoul (optarg, NULL, 0); break;
+            case 'u': update = strtoul (optarg, NULL, 0); break;
+            case 'k': keep = strtol (optarg, NULL, 0); break;
+            case 'S': scheduled = true; break;
+            case 'r': seed = strtoul (optarg, NULL, 0); break;
+            case 's': {
+                char *p;
+                int phys = strtol (optarg, &p, 0);
+                uint16_t lid = *p == ':' ? strtoul (p + 1, NULL, 0) : FRSKY_SP_RPM;
+                if (phys < 0 || phys >= FRSKY_SP_PHYSICAL_IDS) usage ();
+                config.push_back (std::make_pair (phys, lid));
+                break;
+            }
+            default: usage ();
+        }
+    }
+    if (config.empty ()) config.push_back (std::make_pair (4, FRSKY_SP_RPM));
+    blockUs = block;
+
+    hostTimeSet (0);
+    sensors.reserve (config.size ());
+    for (i=0; i<(int) config.size (); i++) {
+        Sensor n;
+        n.port = new SimPort (bus, i, turnaround);
+        n.sp   = new class FrskySP (*n.port);
+        n.slot = new FrskySPSlot (config[i].second);
+        n.next = rnd () % period;           // the sensors do not start together
+        n.nextBlock = 1000000;
+        n.nextValue = 0;
+        n.tasks = new FrskySPScheduler (*n.sp);
+        if (scheduled && block) n.tasks->add (blockTask, 1000);
+        n.port->begin (FRSKY_SP_SPEED);
+        n.sp->attach (config[i].first, n.slot);
+        if (keep >= 0) {
+            n.sp->keepAlive (config[i].first);
+            n.sp->deadline (keep);
+        }
+        bus.ports.push_back (n.port);
+        sensors.push_back (n);
+        n.sp->measure (config[i].first, &sensors.back ().timing);
+    }
+
+    end = seconds * 1e6;
+    for (poll = 0; poll < end; ) {
+        s = NULL;
+        for (Sensor &n : sensors) {
+            if (n.next < poll && (!s || n.next < s->next)) s = &n;
+        }
+
+        if (s) {                            // a loop() of a sensor
+            hostTimeSet (s->next);
+            if (s->next >= s->nextValue) {
+                s->slot->set (rnd () & 0xffff);
+                s->nextValue = s->next + update;
+            }
+            if (scheduled) s->tasks->run ();
+            else           s->sp->update ();
+            s->next = micros () + work + (jitter ? rnd () % (jitter + 1) : 0);
+            if (block && !scheduled && s->next >= s->nextBlock) {
+                s->next += block;
+                s->nextBlock += 1000000;
+            }
+            continue;
+        }
+
+        if (id >= 0) closeSlot (bus, id, prev, pollEnd, poll);
+        prev = id;
+        id   = nextId ();
+        stats[id].polls++;
+        bus.transmit (poll, FRSKY_SP_POLL, -1);
+        bus.transmit (poll + BYTE_US, FrskySPCrc::physicalId (id), -1);
+        pollEnd = poll + 2 * BYTE_US;
+        poll += period;
+    }
+
+    printf ("%.1f s simulated, poll period %lu µs, loop %lu + 0~%lu µs, block %lu µs/s, turnaround %u µs, update %lu µs",
+            seconds, period, work, jitter, block, turnaround, update);
+    if (keep >= 0) printf (", keep-alive %ld µs", keep);
+    if (scheduled) printf (", scheduled");
+    printf ("\n\n");
+    printf ("phys   polls  replies  empty    bad  missed   late  collisions  latency min/avg/max [µs]\n");
+    for (i=0; i<FRSKY_SP_PHYSICAL_IDS; i++) {
+        Stats &t = stats[i];
+        if (!t.replies && !t.empty && !t.bad && !t.missed && !t.late && !t.collisions) continue;
+        printf ("%4d %7lu %8lu %6lu %6lu %7lu %6lu %11lu  ", i, t.polls, t.replies, t.empty, t.bad, t.missed, t.late,
+                t.collisions);
+        if (t.replies) printf ("%lu/%.0f/%lu\n", t.latMin, t.latSum / t.replies, t.latMax);
+        else           printf ("-\n");
+    }
+    for (i=0; i<(int) sensors.size (); i++) {
+        const FrskySPTiming &t = sensors[i].timing;
+        if (!FRSKY_SP_TIMING || !t.count ()) continue;
+        printf ("sensor %d: %u answers, latency p50 %lu, p99 %lu, max %lu µs, tx max %u µs |", i, t.count (),
+                (unsigned long) t.percentile (50), (unsigned long) t.percentile (99), (unsigned long) t.latencyMax (),
+                t.txMax ());
+        for (int b=0; b<FRSKY_SP_TIMING_BUCKETS; b++) {
+            if (t.bucket (b)) printf (" %lu~:%u", b ? 1UL << b : 0UL, t.bucket (b));
+        }
+        printf ("\n");
+    }
+    for (i=0; i<(int) sensors.size (); i++) {
+        const FrskySPScheduler &t = *sensors[i].tasks;
+        if (!scheduled || !block) continue;
+        printf ("sensor %d: poll period %u µs, task cost %u µs, slack min %ld µs, overruns %u\n", i, t.period (),
+                t.cost (0), (long) t.slackMin (), t.overruns ());
+    }
+    for (i=0; i<(int) sensors.size (); i++) {
+        if (sensors[i].port->overflows) printf ("sensor %d: %lu bytes lost (RX buffer full)\n", i, sensors[i].port->overflows);
+    }
+    return 0;
+}